@@ -0,0 +1,409 @@
+// SDL libraries
+#include <SDL.h>
+
+// Game modules
+#include "game.h"
+#include "kernels.h"
+#include "replay.h"
+#include "rng.h"
+
+// Standard libraries
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+// Helper libraries
+#include <stdbool.h>
+
+#pragma region Structs and defines
+
+// Samples taken of every kernel at every size, and the time spent measuring before stopping early
+#define MAX_SAMPLES 2000
+#define MAX_MEASURE_TIME 0.25
+
+// Times the replay is run for the macro benchmark
+#define REPLAY_RUNS 5
+
+// Sizes the kernels are measured at, the first one is the default game
+typedef struct BenchSize
+{
+	int cols, rows;
+	int bullets, particles;
+} BenchSize;
+
+static const BenchSize benchSizes[] = {
+	{ 11, 5, MAX_PROJECTILES, MAX_PARTICLES },
+	{ 40, 25, 1000, 1000 },
+	{ 100, 40, 4000, 4000 },
+	{ 200, 100, 20000, 20000 },
+};
+
+#define BENCH_SIZE_COUNT (int)(sizeof benchSizes / sizeof benchSizes[0])
+
+// A kernel and the setup that is run before every sample, which isn't timed
+typedef struct Kernel
+{
+	const char* name;
+	void (*setup)(void);
+	void (*run)(void);
+} Kernel;
+
+// Summary of the samples of one kernel in nanoseconds
+typedef struct BenchResult
+{
+	int samples;
+	double min, median, mean, p99;
+} BenchResult;
+
+#pragma endregion
+
+#pragma region Globals
+
+static Rng benchRng;
+static double nanosecondsPerCount;
+
+// World the kernels run on, a copy of it right after the game started that the wave setups restore, and a copy to save into
+static World world;
+static WorldSnapshot started;
+static WorldSnapshot scratch;
+
+// Results are written as one JSON object per line, so runs from many commits can be appended to one file
+static FILE* output;
+
+#pragma endregion
+
+#pragma region Setup
+
+// Helper function for a random position inside the field
+static float randomX(void) { return nextRandomFloat(&benchRng) * world.config.fieldWidth; }
+static float randomY(void) { return nextRandomFloat(&benchRng) * world.config.fieldHeight; }
+
+// Fill the bullet store, half of the bullets going up and half going down
+static void fillBullets(void)
+{
+	resetEntityStore(&world.bullets);
+
+	while (world.bullets.count < world.bullets.capacity)
+	{
+		int i = spawnEntity(&world.bullets);
+
+		world.bullets.px[i] = world.bullets.lastPx[i] = randomX();
+		world.bullets.py[i] = world.bullets.lastPy[i] = randomY();
+		world.bullets.tag[i] = (nextRandom(&benchRng) & 1) ? 1 : -1;
+	}
+}
+
+// Fill the particle emitter with births spread over a whole lifetime, so the oldest ones run out on the next tick
+static void fillParticles(void)
+{
+	clearParticles(&world.particles);
+
+	int perTick = (world.particles.capacity + (int)world.particles.lifetime - 1) / (int)world.particles.lifetime;
+	Uint32 first = world.particles.tick;
+
+	for (int n = 0; n < world.particles.capacity; n++)
+	{
+		world.particles.tick = first + (Uint32)(n / perTick);
+
+		float angle = nextRandomFloat(&benchRng) * 2.0f * (float)M_PI;
+		emitParticle(&world.particles, randomX(), randomY(), SDL_cosf(angle) * 100.0f, SDL_sinf(angle) * 100.0f, 7.0f,
+			(nextRandom(&benchRng) & 1) ? SHIP_EXPLOSION : BULLET_EXPLOSION);
+	}
+
+	world.particles.tick = first + world.particles.lifetime - 1;
+}
+
+// Start from a fresh wave with empty bullet and particle stores
+static void setupWave(void)
+{
+	restoreSnapshot(&world, &started);
+}
+
+// A fresh wave where every bottom row enemy is about to shoot
+static void setupShooting(void)
+{
+	setupWave();
+
+	for (int col = 0; col < world.formation.cols; col++)
+		world.enemies.timer[world.formation.bottomRow[col] * world.formation.cols + col] = 0.0f;
+}
+
+// A fresh wave with a full bullet store, the player bullets spread over the formation
+static void setupCollisions(void)
+{
+	setupWave();
+	fillBullets();
+
+	float width = (float)world.formation.cols * (tunables.enemyWidth + FORMATION_GAP);
+	float height = (float)world.formation.rows * (tunables.enemyHeight + FORMATION_GAP);
+
+	for (int n = 0; n < world.bullets.count; n++)
+	{
+		int i = world.bullets.live[n];
+
+		if (world.bullets.tag[i] == -1)
+		{
+			world.bullets.px[i] = world.formation.px + nextRandomFloat(&benchRng) * width;
+			world.bullets.py[i] = world.formation.py + nextRandomFloat(&benchRng) * height;
+		}
+	}
+}
+
+#pragma endregion
+
+#pragma region Kernels
+
+// Run a single tick of every kernel
+static void runUpdateEnemies(void) { updateEnemies(&world, (float)TICK_TIME); }
+static void runUpdateBullets(void) { updateBullets(&world, (float)TICK_TIME); }
+static void runUpdateParticles(void) { updateParticles(&world); }
+static void runEnemyShoot(void) { enemyShoot(&world, (float)TICK_TIME); }
+static void runCheckBulletCollisions(void) { checkBulletCollisions(&world); }
+static void runCheckGameState(void) { checkGameState(&world); }
+static void runSaveSnapshot(void) { saveSnapshot(&scratch, &world); }
+static void runRestoreSnapshot(void) { restoreSnapshot(&world, &started); }
+
+static const Kernel kernels[] = {
+	{ "updateEnemies", setupWave, runUpdateEnemies },
+	{ "updateBullets", fillBullets, runUpdateBullets },
+	{ "updateParticles", fillParticles, runUpdateParticles },
+	{ "enemyShoot", setupShooting, runEnemyShoot },
+	{ "checkBulletCollisions", setupCollisions, runCheckBulletCollisions },
+	{ "checkGameState", setupWave, runCheckGameState },
+	{ "saveSnapshot", setupCollisions, runSaveSnapshot },
+	{ "restoreSnapshot", setupCollisions, runRestoreSnapshot },
+};
+
+#define KERNEL_COUNT (int)(sizeof kernels / sizeof kernels[0])
+
+#pragma endregion
+
+// Helper function for sorting samples
+static int compareSamples(const void* a, const void* b)
+{
+	double x = *(const double*)a;
+	double y = *(const double*)b;
+
+	return (x > y) - (x < y);
+}
+
+// Function that sorts the samples and summarizes them
+static BenchResult summarize(double* samples, int count)
+{
+	BenchResult result = { .samples = count };
+	if (count == 0)
+		return result;
+
+	qsort(samples, count, sizeof(double), compareSamples);
+
+	double sum = 0.0;
+	for (int i = 0; i < count; i++)
+		sum += samples[i];
+
+	result.min = samples[0];
+	result.median = samples[count / 2];
+	result.mean = sum / count;
+	result.p99 = samples[(count - 1) * 99 / 100];
+
+	return result;
+}
+
+// Function that times one kernel, running its setup before every sample
+static BenchResult measureKernel(const Kernel* kernel)
+{
+	static double samples[MAX_SAMPLES];
+	int count = 0;
+	double measured = 0.0;
+
+	while (count < MAX_SAMPLES && measured < MAX_MEASURE_TIME * 1e9)
+	{
+		kernel->setup();
+
+		Uint64 start = SDL_GetPerformanceCounter();
+		kernel->run();
+		Uint64 end = SDL_GetPerformanceCounter();
+
+		samples[count] = (double)(end - start) * nanosecondsPerCount;
+		measured += samples[count];
+		count++;
+	}
+
+	return summarize(samples, count);
+}
+
+// Function that measures every kernel at every size, once for every vector level up to the given one
+static bool runKernelBenchmarks(unsigned int seed, KernelLevel widest)
+{
+	for (int s = 0; s < BENCH_SIZE_COUNT; s++)
+	{
+		const BenchSize* size = &benchSizes[s];
+
+		char formationSize[32];
+		snprintf(formationSize, sizeof formationSize, "%dx%d", size->cols, size->rows);
+
+		char bulletCount[16], particleCount[16];
+		snprintf(bulletCount, sizeof bulletCount, "%d", size->bullets);
+		snprintf(particleCount, sizeof particleCount, "%d", size->particles);
+
+		char* args[] = { "bench", "--formation", formationSize, "--bullets", bulletCount, "--particles", particleCount };
+
+		GameConfig config;
+		parseGameConfig((int)(sizeof args / sizeof args[0]), args, &config);
+
+		if (!initGame(&world, seed, &config))
+		{
+			quitGame(&world);
+			return false;
+		}
+
+		// Every kernel starts from the game as it is right after leaving the menu
+		PlayerInput start = { .shoot = true };
+		update(&world, &start, (float)TICK_TIME);
+
+		if (!createSnapshot(&started, &world) || !createSnapshot(&scratch, &world))
+		{
+			freeSnapshot(&started);
+			quitGame(&world);
+			return false;
+		}
+
+		seedRandom(&benchRng, seed);
+
+		for (int k = 0; k < KERNEL_COUNT; k++)
+		{
+			for (int level = KERNELS_SCALAR; level <= (int)widest; level++)
+			{
+				KernelLevel used = initKernels(&(KernelOptions){ .level = (KernelLevel)level });
+				BenchResult result = measureKernel(&kernels[k]);
+
+				fprintf(output, "{ \"bench\": \"%s\", \"simd\": \"%s\", \"enemies\": %d, \"bullets\": %d, \"particles\": %d, \"samples\": %d, "
+					"\"min_ns\": %.1f, \"median_ns\": %.1f, \"mean_ns\": %.1f, \"p99_ns\": %.1f }\n",
+					kernels[k].name, getKernelLevelName(used), world.enemies.capacity, world.bullets.capacity, world.particles.capacity, result.samples,
+					result.min, result.median, result.mean, result.p99);
+			}
+		}
+
+		freeSnapshot(&scratch);
+		freeSnapshot(&started);
+		quitGame(&world);
+	}
+
+	return true;
+}
+
+// Function that plays a recorded session several times and times every tick that isn't spent in the menu
+static bool runReplayBenchmark(const char* path, const GameConfig* config)
+{
+	// The recording brings the config it was played with
+	GameConfig recorded = *config;
+
+	InputReplay loaded;
+	if (!loadReplay(&loaded, path, &recorded))
+		return false;
+
+	bool success = true;
+
+	for (int run = 0; run < REPLAY_RUNS && success; run++)
+	{
+		// Every run starts from the beginning of the recording
+		InputReplay replay = loaded;
+
+		if (!initGame(&world, replay.seed, &recorded))
+		{
+			success = false;
+			break;
+		}
+
+		Uint64 ticks = 0, timedTicks = 0, counts = 0;
+		PlayerInput input;
+
+		while (nextReplayInput(&replay, &input))
+		{
+			// Menu ticks only wait for the start, so they aren't part of the result
+			bool timed = world.playGame;
+
+			Uint64 start = SDL_GetPerformanceCounter();
+			update(&world, &input, (float)TICK_TIME);
+			Uint64 end = SDL_GetPerformanceCounter();
+
+			if (timed)
+			{
+				counts += end - start;
+				timedTicks++;
+			}
+
+			ticks++;
+		}
+
+		double nanoseconds = (double)counts * nanosecondsPerCount;
+		bool match = !replay.hasFooter || (replay.expectedHash == hashGameState(&world) && replay.expectedTicks == ticks);
+
+		fprintf(output, "{ \"bench\": \"replay\", \"simd\": \"%s\", \"file\": \"%s\", \"run\": %d, \"enemies\": %d, \"ticks\": %llu, \"timed_ticks\": %llu, "
+			"\"ns_per_tick\": %.1f, \"ticks_per_s\": %.0f, \"match\": %s }\n",
+			getKernelLevelName(getKernelLevel()), path, run, world.enemies.capacity, (unsigned long long)ticks, (unsigned long long)timedTicks,
+			timedTicks > 0 ? nanoseconds / (double)timedTicks : 0.0,
+			nanoseconds > 0 ? (double)timedTicks * 1e9 / nanoseconds : 0.0, match ? "true" : "false");
+
+		// A replay that plays out differently isn't measuring the same work
+		if (!match)
+		{
+			printf("Replay %s desynced on run %d, the simulation played out differently from the recording\n", path, run);
+			success = false;
+		}
+
+		quitGame(&world);
+	}
+
+	freeReplay(&loaded);
+	return success;
+}
+
+int main(int argc, char* argv[])
+{
+	const char* outputPath = NULL;
+	const char* replayPath = NULL;
+	unsigned int seed = 1;
+
+	for (int i = 1; i < argc - 1; i++)
+	{
+		if (strcmp(argv[i], "--out") == 0)
+			outputPath = argv[++i];
+		else if (strcmp(argv[i], "--replay") == 0)
+			replayPath = argv[++i];
+		else if (strcmp(argv[i], "--seed") == 0)
+			seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+	}
+
+	output = outputPath ? fopen(outputPath, "a") : stdout;
+	if (!output)
+	{
+		printf("Couldn't open %s for the results\n", outputPath);
+		return 1;
+	}
+
+	nanosecondsPerCount = 1e9 / (double)SDL_GetPerformanceFrequency();
+
+	// Kernels are measured at every level up to "--simd", the replay only at that level
+	KernelOptions kernelOptions;
+	parseKernelOptions(argc, argv, &kernelOptions);
+
+	KernelLevel widest = initKernels(&kernelOptions);
+
+	bool success = runKernelBenchmarks(seed, widest);
+	initKernels(&kernelOptions);
+
+	// The replay adopts the config it was recorded with, only the authored waves come from the command line and have to match
+	// the recording, given with the same "--waves FILE"
+	if (success && replayPath)
+	{
+		GameConfig config;
+		parseGameConfig(argc, argv, &config);
+
+		success = runReplayBenchmark(replayPath, &config);
+	}
+
+	if (output != stdout)
+		fclose(output);
+
+	return success ? 0 : 1;
+}
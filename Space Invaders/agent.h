@@ -0,0 +1,80 @@
+#pragma once
+
+// C interface between the game and an external policy in a shared library, given with "--agent LIB".
+// Only plain C types are used, so a policy can be built against this header alone, with any compiler or language that speaks C.
+//
+// The library exports the three functions below under these names. The game creates an agent for every thread it steps games on,
+// so an agent is only ever used by one thread at a time, while different agents may be stepped side by side:
+//
+//   void* createAgent(int32_t version, int32_t instances);
+//       Called with AGENT_API_VERSION and the most games that are stepped at once. Returns NULL to refuse the version or on failure
+//   void stepAgents(void* agent, const AgentObservation* observations, AgentAction* actions, int32_t count);
+//       Called once per tick with an observation for each game being stepped, fills in an action for each
+//   void destroyAgent(void* agent);
+
+// Helper libraries
+#include <stdint.h>
+
+#pragma region Structs and defines
+
+// Changes whenever a struct below changes
+#define AGENT_API_VERSION 1
+
+// Libraries mark the three functions with it
+#if defined(_WIN32)
+#define AGENT_EXPORT __declspec(dllexport)
+#else
+#define AGENT_EXPORT __attribute__((visibility("default")))
+#endif
+
+// What a policy sees of a game at the start of a tick. The arrays are the game's own, nothing is copied into them,
+// so they are only valid during the stepAgents call and must never be written to
+typedef struct AgentObservation
+{
+	uint64_t tick; // Ticks since the game started, at 120 ticks per second
+	uint32_t seed; // Seed of the game, different for every game of a batch, so a policy can draw random numbers of its own per game
+	int32_t playing; // 0 while the menu shows, actions are ignored then and the game is started for the policy
+
+	int32_t score, livesLeft, wave;
+
+	// Top-left corner of the player and its size
+	float playerX, playerY;
+	float playerWidth, playerHeight;
+
+	// The formation moves as one. The enemy in column c and row r has its top-left corner at
+	// (formationX + c * cellWidth, formationY + r * cellHeight), and is alive if bit (r * cols + c) of aliveMask is set
+	float formationX, formationY;
+	float cellWidth, cellHeight;
+	float enemyWidth, enemyHeight;
+	int32_t cols, rows;
+	const uint32_t* aliveMask; // 32 cells per word
+
+	// Bullets by slot. The first bulletCount entries of bulletSlots are the live slots, bulletDir is -1 for shots of the player
+	// and 1 for shots of enemies
+	const int32_t* bulletSlots;
+	int32_t bulletCount;
+	const float* bulletX;
+	const float* bulletY;
+	const int32_t* bulletDir;
+	float bulletWidth, bulletHeight;
+
+	// Play field, everything above is in its pixels
+	float fieldWidth, fieldHeight;
+} AgentObservation;
+
+// What a policy does during a tick, every field is 0 or 1
+typedef struct AgentAction
+{
+	uint8_t left, right, shoot;
+	uint8_t reserved; // Left at 0
+} AgentAction;
+
+#pragma endregion
+
+#pragma region Function types
+
+typedef void* (*CreateAgentFunction)(int32_t version, int32_t instances);
+typedef void (*StepAgentsFunction)(void* agent, const AgentObservation* observations, AgentAction* actions, int32_t count);
+typedef void (*DestroyAgentFunction)(void* agent);
+
+#pragma endregion
@@ -0,0 +1,152 @@
+#include "agenthost.h"
+
+// Standard libraries
+#include <stdlib.h>
+#include <stdio.h>
+
+// The game's int arrays are handed to policies as int32_t arrays without a copy
+SDL_COMPILE_TIME_ASSERT(agentIntSize, sizeof(int) == sizeof(int32_t));
+
+// Function that loads a policy library and looks up the three functions it exports
+bool loadAgentLibrary(AgentLibrary* library, const char* path)
+{
+	*library = (AgentLibrary){ NULL };
+
+	library->handle = SDL_LoadObject(path);
+	if (!library->handle)
+	{
+		printf("Couldn't load the agent %s: %s\n", path, SDL_GetError());
+		return false;
+	}
+
+	library->create = (CreateAgentFunction)SDL_LoadFunction(library->handle, "createAgent");
+	library->step = (StepAgentsFunction)SDL_LoadFunction(library->handle, "stepAgents");
+	library->destroy = (DestroyAgentFunction)SDL_LoadFunction(library->handle, "destroyAgent");
+
+	if (!library->create || !library->step || !library->destroy)
+	{
+		printf("The agent %s doesn't export createAgent, stepAgents and destroyAgent\n", path);
+		unloadAgentLibrary(library);
+		return false;
+	}
+
+	return true;
+}
+
+// Function that unloads a policy library
+void unloadAgentLibrary(AgentLibrary* library)
+{
+	if (library->handle)
+		SDL_UnloadObject(library->handle);
+
+	*library = (AgentLibrary){ NULL };
+}
+
+// Function that creates an agent and the arrays it is stepped with
+bool createAgentGroup(AgentGroup* group, const AgentLibrary* library, int capacity)
+{
+	*group = (AgentGroup){ .library = library, .capacity = capacity };
+
+	group->observations = (AgentObservation*)calloc((size_t)capacity, sizeof(AgentObservation));
+	group->actions = (AgentAction*)calloc((size_t)capacity, sizeof(AgentAction));
+
+	if (!group->observations || !group->actions)
+	{
+		printf("Couldn't allocate the observations of %d games\n", capacity);
+		destroyAgentGroup(group);
+		return false;
+	}
+
+	group->agent = library->create(AGENT_API_VERSION, capacity);
+	if (!group->agent)
+	{
+		printf("createAgent returned NULL for version %d of the interface, it doesn't support it or failed\n", AGENT_API_VERSION);
+		destroyAgentGroup(group);
+		return false;
+	}
+
+	return true;
+}
+
+// Function that destroys an agent and frees its arrays
+void destroyAgentGroup(AgentGroup* group)
+{
+	if (group->agent)
+		group->library->destroy(group->agent);
+
+	free(group->observations);
+	free(group->actions);
+
+	*group = (AgentGroup){ NULL };
+}
+
+// Helper function that points an observation at the arrays of a world, only the scalars are written
+static void observeWorld(AgentObservation* observation, const World* world, unsigned int seed, Uint64 tick)
+{
+	const Formation* formation = &world->formation;
+	const EntityStore* bullets = &world->bullets;
+
+	*observation = (AgentObservation){
+		.tick = tick,
+		.seed = seed,
+		.playing = world->playGame,
+
+		.score = world->player.score,
+		.livesLeft = world->player.livesLeft,
+		.wave = world->currentWave,
+
+		.playerX = world->player.px,
+		.playerY = world->player.py,
+		.playerWidth = tunables.playerWidth,
+		.playerHeight = tunables.playerHeight,
+
+		.formationX = formation->px,
+		.formationY = formation->py,
+		.cellWidth = tunables.enemyWidth + FORMATION_GAP,
+		.cellHeight = tunables.enemyHeight + FORMATION_GAP,
+		.enemyWidth = tunables.enemyWidth,
+		.enemyHeight = tunables.enemyHeight,
+		.cols = formation->cols,
+		.rows = formation->rows,
+		.aliveMask = formation->cellMask,
+
+		.bulletSlots = (const int32_t*)bullets->live,
+		.bulletCount = bullets->count,
+		.bulletX = bullets->px,
+		.bulletY = bullets->py,
+		.bulletDir = (const int32_t*)bullets->tag,
+		.bulletWidth = tunables.bulletWidth,
+		.bulletHeight = tunables.bulletHeight,
+
+		.fieldWidth = world->config.fieldWidth,
+		.fieldHeight = world->config.fieldHeight,
+	};
+}
+
+// Function that steps the policy once for a group of worlds, which all sit at the same tick
+void stepAgentGroup(AgentGroup* group, const World* worlds, const unsigned int* seeds, int count, Uint64 tick, PlayerInput* inputs)
+{
+	for (int n = 0; n < count; n++)
+	{
+		observeWorld(&group->observations[n], &worlds[n], seeds[n], tick);
+		group->actions[n] = (AgentAction){ 0 };
+	}
+
+	group->library->step(group->agent, group->observations, group->actions, count);
+
+	for (int n = 0; n < count; n++)
+	{
+		// Start the game from the menu like a player would, the same as the built-in controllers
+		if (!worlds[n].playGame)
+		{
+			inputs[n] = (PlayerInput){ .shoot = true };
+			continue;
+		}
+
+		inputs[n] = (PlayerInput){
+			.left = group->actions[n].left != 0,
+			.right = group->actions[n].right != 0,
+			.shoot = group->actions[n].shoot != 0,
+		};
+	}
+}
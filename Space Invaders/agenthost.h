@@ -0,0 +1,54 @@
+#pragma once
+
+// SDL libraries
+#include <SDL.h>
+
+// Game modules
+#include "agent.h"
+#include "game.h"
+
+// Helper libraries
+#include <stdbool.h>
+
+#pragma region Structs and defines
+
+// Games a batch worker steps together when "--agent-batch N" isn't given
+#define DEFAULT_AGENT_BATCH 64
+
+// Shared library with a policy, loaded once and used by every thread
+typedef struct AgentLibrary
+{
+	void* handle;
+
+	CreateAgentFunction create;
+	StepAgentsFunction step;
+	DestroyAgentFunction destroy;
+} AgentLibrary;
+
+// Agent of a single thread, with room for the observations and actions of every game it steps at once
+typedef struct AgentGroup
+{
+	const AgentLibrary* library;
+	void* agent;
+
+	int capacity;
+	AgentObservation* observations;
+	AgentAction* actions;
+} AgentGroup;
+
+#pragma endregion
+
+#pragma region Function declarations
+
+// Loading, the library stays loaded until every group created from it is destroyed
+bool loadAgentLibrary(AgentLibrary* library, const char* path);
+void unloadAgentLibrary(AgentLibrary* library);
+
+// Creation of an agent that steps at most capacity games at once, only used by the thread that created it
+bool createAgentGroup(AgentGroup* group, const AgentLibrary* library, int capacity);
+void destroyAgentGroup(AgentGroup* group);
+
+// Ask the policy for the input of the next tick of every given world. Worlds on the menu are started like a player would
+void stepAgentGroup(AgentGroup* group, const World* worlds, const unsigned int* seeds, int count, Uint64 tick, PlayerInput* inputs);
+
+#pragma endregion
@@ -0,0 +1,512 @@
+#include "assets.h"
+
+// Standard libraries
+#include <stdio.h>
+#include <string.h>
+
+// File layout, all little-endian:
+//   header:  "SIPK", version (u16), asset count (u16)
+//   entries: offset (u32), size (u32) and three parameters (u32) for every AssetId
+//   data:    font file, sprite rects (4 u32 each) followed by RGBA pixels, PCM samples of each sound
+#define PACK_MAGIC "SIPK"
+#define PACK_VERSION 1
+#define PACK_HEADER_SIZE 8
+#define PACK_ENTRY_SIZE 20
+#define PACK_PARAMS 3
+
+// Every asset starts at a multiple of this, so samples and pixels are aligned in memory
+#define PACK_ALIGNMENT 16
+#define ALIGN_OFFSET(offset) (((offset) + PACK_ALIGNMENT - 1) & ~(Uint32)(PACK_ALIGNMENT - 1))
+
+// Widest and tallest sprite sheet a pack may hold, larger than any texture a renderer takes
+#define MAX_SHEET_SIZE 16384
+
+// The pack is used when it exists next to the executable, otherwise these loose files are
+#define DEFAULT_PACK_FILE "assets.pak"
+#define FONT_FILE "rubik-reg.ttf"
+
+#pragma region Structs
+
+// A single asset, pointing into the loaded pack
+typedef struct Asset
+{
+	const Uint8* data;
+	Uint32 size;
+
+	// Sprites: width and height of the sheet. Sounds: frequency, format and channels of the samples
+	Uint32 params[PACK_PARAMS];
+} Asset;
+
+#pragma endregion
+
+#pragma region Globals
+
+// Contents of the pack file, NULL when loose files are used
+static Uint8* packData = NULL;
+static size_t packSize = 0;
+static Asset assets[ASSET_COUNT];
+
+// Loose files, the player is a solid sprite tinted green so it has no file
+static const char* const spriteFiles[SPRITE_COUNT] = {
+	[SPRITE_PLAYER] = NULL,
+	[SPRITE_ENEMY] = "enemy.png",
+	[SPRITE_BULLET] = "bullet.png",
+	[SPRITE_BULLET_EXPLOSION] = "bullet_destroy_particle.png",
+	[SPRITE_SHIP_EXPLOSION] = "ship_destroy_particle.png",
+};
+
+static const char* const soundFiles[SOUND_COUNT] = {
+	[SOUND_SHOOT] = "shoot_sound.wav",
+	[SOUND_HIT] = "hit_sound.wav",
+};
+
+#pragma endregion
+
+#pragma region Loading
+
+// Function for getting the asset options from the command line
+void parseAssetOptions(int argc, char* argv[], AssetOptions* options)
+{
+	options->packPath = DEFAULT_PACK_FILE;
+	options->writePath = NULL;
+
+	for (int i = 1; i < argc - 1; i++)
+	{
+		if (strcmp(argv[i], "--assets") == 0)
+			options->packPath = argv[++i];
+		else if (strcmp(argv[i], "--pack") == 0)
+			options->writePath = argv[++i];
+	}
+}
+
+// Helper function that reads the entry table of the loaded pack and checks that every asset lies inside the file
+static bool readPackEntries(const char* path)
+{
+	if (packSize < PACK_HEADER_SIZE + ASSET_COUNT * PACK_ENTRY_SIZE || memcmp(packData, PACK_MAGIC, 4) != 0)
+	{
+		printf("%s is not an asset pack\n", path);
+		return false;
+	}
+
+	SDL_RWops* header = SDL_RWFromConstMem(packData, (int)packSize);
+	SDL_RWseek(header, 4, RW_SEEK_SET);
+
+	Uint16 version = SDL_ReadLE16(header);
+	Uint16 count = SDL_ReadLE16(header);
+
+	if (version != PACK_VERSION || count != ASSET_COUNT)
+	{
+		printf("%s has version %d with %d assets, expected version %d with %d\n", path, version, count, PACK_VERSION, ASSET_COUNT);
+		SDL_RWclose(header);
+		return false;
+	}
+
+	bool success = true;
+	for (int i = 0; i < ASSET_COUNT; i++)
+	{
+		Uint32 offset = SDL_ReadLE32(header);
+		Uint32 size = SDL_ReadLE32(header);
+
+		for (int p = 0; p < PACK_PARAMS; p++)
+			assets[i].params[p] = SDL_ReadLE32(header);
+
+		if (size == 0 || offset > packSize || size > packSize - offset)
+		{
+			printf("Asset %d of %s is missing or cut off\n", i, path);
+			success = false;
+			continue;
+		}
+
+		assets[i].data = packData + offset;
+		assets[i].size = size;
+	}
+
+	SDL_RWclose(header);
+
+	// The sprite sheet has to hold its rects and every pixel. The size is worked out in 64 bits, so a damaged width and height
+	// can't wrap around to a product that matches
+	const Asset* sprites = &assets[ASSET_SPRITES];
+	Uint32 sheetWidth = sprites->params[0], sheetHeight = sprites->params[1];
+
+	if (success && (sheetWidth == 0 || sheetHeight == 0 || sheetWidth > MAX_SHEET_SIZE || sheetHeight > MAX_SHEET_SIZE ||
+		sprites->size != SPRITE_COUNT * 16 + (Uint64)sheetWidth * sheetHeight * 4))
+	{
+		printf("Sprite sheet of %s has the wrong size\n", path);
+		success = false;
+	}
+
+	return success;
+}
+
+// Helper function that checks a loose file can be opened
+static bool checkLooseFile(const char* file)
+{
+	SDL_RWops* rw = SDL_RWFromFile(file, "rb");
+	if (!rw)
+	{
+		printf("Missing asset %s: %s\n", file, SDL_GetError());
+		return false;
+	}
+
+	SDL_RWclose(rw);
+	return true;
+}
+
+// Function that loads the asset pack in one read, or checks that every loose file is there when there is no pack
+bool loadAssets(const char* packPath)
+{
+	SDL_RWops* file = packPath ? SDL_RWFromFile(packPath, "rb") : NULL;
+
+	if (file)
+	{
+		packData = SDL_LoadFile_RW(file, &packSize, 1);
+		if (!packData)
+		{
+			printf("Couldn't read %s: %s\n", packPath, SDL_GetError());
+			return false;
+		}
+
+		if (!readPackEntries(packPath))
+		{
+			freeAssets();
+			return false;
+		}
+
+		return true;
+	}
+
+	bool success = checkLooseFile(FONT_FILE);
+
+	for (int i = 0; i < SPRITE_COUNT; i++)
+		if (spriteFiles[i] && !checkLooseFile(spriteFiles[i]))
+			success = false;
+
+	for (int i = 0; i < SOUND_COUNT; i++)
+		if (!checkLooseFile(soundFiles[i]))
+			success = false;
+
+	return success;
+}
+
+// Free the pack, nothing may point into it afterwards
+void freeAssets(void)
+{
+	SDL_free(packData);
+	packData = NULL;
+	packSize = 0;
+
+	memset(assets, 0, sizeof assets);
+}
+
+#pragma endregion
+
+#pragma region Packing
+
+// Helper function that converts a sound file to the format the mixer is opened with
+static bool loadSoundSamples(const char* file, Uint8** samples, Uint32* size)
+{
+	SDL_AudioSpec spec;
+	if (!SDL_LoadWAV(file, &spec, samples, size))
+	{
+		printf("Couldn't load sound %s: %s\n", file, SDL_GetError());
+		return false;
+	}
+
+	SDL_AudioCVT cvt;
+	int needed = SDL_BuildAudioCVT(&cvt, spec.format, spec.channels, spec.freq, AUDIO_FORMAT, AUDIO_CHANNELS, AUDIO_FREQUENCY);
+
+	if (needed == 0)
+		return true;
+
+	if (needed < 0)
+	{
+		printf("Couldn't convert sound %s: %s\n", file, SDL_GetError());
+		SDL_FreeWAV(*samples);
+		return false;
+	}
+
+	cvt.len = (int)*size;
+	cvt.buf = SDL_malloc((size_t)cvt.len * cvt.len_mult);
+	if (!cvt.buf)
+	{
+		SDL_FreeWAV(*samples);
+		return false;
+	}
+
+	memcpy(cvt.buf, *samples, *size);
+	SDL_FreeWAV(*samples);
+
+	if (SDL_ConvertAudio(&cvt) != 0)
+	{
+		printf("Couldn't convert sound %s: %s\n", file, SDL_GetError());
+		SDL_free(cvt.buf);
+		return false;
+	}
+
+	// Both buffers are freed with SDL_free
+	*samples = cvt.buf;
+	*size = (Uint32)cvt.len_cvt;
+	return true;
+}
+
+// Function that builds an asset pack from the loose files
+bool writeAssetPack(const char* path)
+{
+	bool success = true;
+
+	Uint8* data[ASSET_COUNT] = { NULL };
+	Uint32 sizes[ASSET_COUNT] = { 0 };
+	Uint32 params[ASSET_COUNT][PACK_PARAMS] = { { 0 } };
+
+	// Font, stored as is
+	size_t fontSize = 0;
+	data[ASSET_FONT] = SDL_LoadFile(FONT_FILE, &fontSize);
+	sizes[ASSET_FONT] = (Uint32)fontSize;
+
+	if (!data[ASSET_FONT])
+	{
+		printf("Couldn't load font %s: %s\n", FONT_FILE, SDL_GetError());
+		success = false;
+	}
+
+	// Sprite sheet, decoded so loading it is a copy to the GPU
+	SpriteSheet sheet;
+	if (createSpriteSheet(&sheet, spriteFiles))
+	{
+		int width = sheet.surface->w, height = sheet.surface->h;
+
+		sizes[ASSET_SPRITES] = SPRITE_COUNT * 16 + width * height * 4;
+		params[ASSET_SPRITES][0] = width;
+		params[ASSET_SPRITES][1] = height;
+
+		data[ASSET_SPRITES] = SDL_malloc(sizes[ASSET_SPRITES]);
+		if (data[ASSET_SPRITES])
+		{
+			SDL_RWops* out = SDL_RWFromMem(data[ASSET_SPRITES], (int)sizes[ASSET_SPRITES]);
+
+			for (int i = 0; i < SPRITE_COUNT; i++)
+			{
+				SDL_WriteLE32(out, sheet.rects[i].x);
+				SDL_WriteLE32(out, sheet.rects[i].y);
+				SDL_WriteLE32(out, sheet.rects[i].w);
+				SDL_WriteLE32(out, sheet.rects[i].h);
+			}
+
+			// Rows without the surface's pitch padding
+			for (int y = 0; y < height; y++)
+				SDL_RWwrite(out, (Uint8*)sheet.surface->pixels + y * sheet.surface->pitch, 4, width);
+
+			SDL_RWclose(out);
+		}
+		else
+		{
+			success = false;
+		}
+
+		freeSpriteSheet(&sheet);
+	}
+	else
+	{
+		success = false;
+	}
+
+	// Sounds, as PCM in the mixer's format
+	for (int i = 0; i < SOUND_COUNT; i++)
+	{
+		AssetId asset = ASSET_SOUND_SHOOT + i;
+
+		if (loadSoundSamples(soundFiles[i], &data[asset], &sizes[asset]))
+		{
+			params[asset][0] = AUDIO_FREQUENCY;
+			params[asset][1] = AUDIO_FORMAT;
+			params[asset][2] = AUDIO_CHANNELS;
+		}
+		else
+		{
+			success = false;
+		}
+	}
+
+	// Write the header, the entry table and the data
+	SDL_RWops* file = success ? SDL_RWFromFile(path, "wb") : NULL;
+
+	if (file)
+	{
+		SDL_RWwrite(file, PACK_MAGIC, 1, 4);
+		SDL_WriteLE16(file, PACK_VERSION);
+		SDL_WriteLE16(file, ASSET_COUNT);
+
+		Uint32 offsets[ASSET_COUNT];
+		Uint32 offset = PACK_HEADER_SIZE + ASSET_COUNT * PACK_ENTRY_SIZE;
+
+		for (int i = 0; i < ASSET_COUNT; i++)
+		{
+			offsets[i] = ALIGN_OFFSET(offset);
+			offset = offsets[i] + sizes[i];
+
+			SDL_WriteLE32(file, offsets[i]);
+			SDL_WriteLE32(file, sizes[i]);
+
+			for (int p = 0; p < PACK_PARAMS; p++)
+				SDL_WriteLE32(file, params[i][p]);
+		}
+
+		// Pad up to the start of each asset
+		static const Uint8 padding[PACK_ALIGNMENT] = { 0 };
+		Uint32 written = PACK_HEADER_SIZE + ASSET_COUNT * PACK_ENTRY_SIZE;
+
+		for (int i = 0; i < ASSET_COUNT; i++)
+		{
+			SDL_RWwrite(file, padding, 1, offsets[i] - written);
+
+			if (SDL_RWwrite(file, data[i], 1, sizes[i]) != sizes[i])
+				success = false;
+
+			written = offsets[i] + sizes[i];
+		}
+
+		if (SDL_RWclose(file) != 0)
+			success = false;
+
+		if (success)
+			printf("Wrote asset pack %s, %u bytes\n", path, offset);
+		else
+			printf("Couldn't write asset pack %s: %s\n", path, SDL_GetError());
+	}
+	else if (success)
+	{
+		printf("Couldn't open %s for the asset pack: %s\n", path, SDL_GetError());
+		success = false;
+	}
+
+	for (int i = 0; i < ASSET_COUNT; i++)
+		SDL_free(data[i]);
+
+	return success;
+}
+
+#pragma endregion
+
+#pragma region Access
+
+// Function that opens the font for TTF_OpenFontRW, which closes it again
+SDL_RWops* openFontAsset(void)
+{
+	SDL_RWops* rw = packData
+		? SDL_RWFromConstMem(assets[ASSET_FONT].data, (int)assets[ASSET_FONT].size)
+		: SDL_RWFromFile(FONT_FILE, "rb");
+
+	if (!rw)
+		printf("Couldn't open font %s: %s\n", FONT_FILE, SDL_GetError());
+
+	return rw;
+}
+
+// Function that creates a chunk for a sound. Packed samples are used in place when they match the mixer's format
+Mix_Chunk* loadSoundAsset(Sound sound)
+{
+	if (!packData)
+	{
+		Mix_Chunk* chunk = Mix_LoadWAV(soundFiles[sound]);
+		if (!chunk)
+			printf("Couldn't load sound %s: %s\n", soundFiles[sound], Mix_GetError());
+
+		return chunk;
+	}
+
+	const Asset* asset = &assets[ASSET_SOUND_SHOOT + sound];
+
+	int frequency, channels;
+	Uint16 format;
+	Mix_QuerySpec(&frequency, &format, &channels);
+
+	SDL_AudioCVT cvt;
+	int needed = SDL_BuildAudioCVT(&cvt, (SDL_AudioFormat)asset->params[1], (Uint8)asset->params[2], (int)asset->params[0], format, (Uint8)channels, frequency);
+
+	if (needed == 0)
+		return Mix_QuickLoad_RAW((Uint8*)asset->data, asset->size);
+
+	// The mixer was opened with a different format than the pack was built for
+	cvt.len = (int)asset->size;
+	cvt.buf = needed > 0 ? SDL_malloc((size_t)cvt.len * cvt.len_mult) : NULL;
+
+	if (!cvt.buf)
+	{
+		printf("Couldn't convert packed sound %s: %s\n", soundFiles[sound], SDL_GetError());
+		return NULL;
+	}
+
+	memcpy(cvt.buf, asset->data, asset->size);
+
+	if (SDL_ConvertAudio(&cvt) != 0)
+	{
+		printf("Couldn't convert packed sound %s: %s\n", soundFiles[sound], SDL_GetError());
+		SDL_free(cvt.buf);
+		return NULL;
+	}
+
+	Mix_Chunk* chunk = Mix_QuickLoad_RAW(cvt.buf, (Uint32)cvt.len_cvt);
+	if (chunk)
+		chunk->allocated = 1; // So Mix_FreeChunk frees the converted samples
+	else
+		SDL_free(cvt.buf);
+
+	return chunk;
+}
+
+// Helper function that decodes the loose sprite files on the worker thread
+static int SDLCALL loadSpritesThread(void* data)
+{
+	SpriteLoader* loader = (SpriteLoader*)data;
+	loader->success = createSpriteSheet(&loader->sheet, spriteFiles);
+
+	return 0;
+}
+
+// Function that starts loading the sprite sheet
+void startLoadingSprites(SpriteLoader* loader)
+{
+	SDL_zerop(loader);
+
+	if (packData)
+	{
+		// Already decoded, the surface uses the pixels in the pack
+		const Asset* asset = &assets[ASSET_SPRITES];
+		SDL_RWops* rects = SDL_RWFromConstMem(asset->data, SPRITE_COUNT * 16);
+
+		for (int i = 0; i < SPRITE_COUNT; i++)
+		{
+			loader->sheet.rects[i].x = (int)SDL_ReadLE32(rects);
+			loader->sheet.rects[i].y = (int)SDL_ReadLE32(rects);
+			loader->sheet.rects[i].w = (int)SDL_ReadLE32(rects);
+			loader->sheet.rects[i].h = (int)SDL_ReadLE32(rects);
+		}
+
+		SDL_RWclose(rects);
+
+		int width = (int)asset->params[0], height = (int)asset->params[1];
+		loader->sheet.surface = SDL_CreateRGBSurfaceWithFormatFrom((void*)(asset->data + SPRITE_COUNT * 16), width, height, 32, width * 4, SDL_PIXELFORMAT_RGBA32);
+		loader->success = loader->sheet.surface != NULL;
+		return;
+	}
+
+	loader->thread = SDL_CreateThread(loadSpritesThread, "Sprite loader", loader);
+
+	// Decode right away if there is no thread to do it
+	if (!loader->thread)
+		loadSpritesThread(loader);
+}
+
+// Function that waits for the sprite sheet. Returns false if it couldn't be loaded
+bool finishLoadingSprites(SpriteLoader* loader)
+{
+	if (loader->thread)
+	{
+		SDL_WaitThread(loader->thread, NULL);
+		loader->thread = NULL;
+	}
+
+	return loader->success;
+}
+
+#pragma endregion
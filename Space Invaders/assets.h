@@ -0,0 +1,56 @@
+#pragma once
+
+// SDL libraries
+#include <SDL.h>
+#include <SDL_mixer.h>
+
+// Game modules
+#include "audio.h"
+#include "sprites.h"
+
+// Helper libraries
+#include <stdbool.h>
+
+#pragma region Structs and ENUMs
+
+// Everything stored in an asset pack. Sounds are in the same order as Sound
+typedef enum AssetId { ASSET_FONT, ASSET_SPRITES, ASSET_SOUND_SHOOT, ASSET_SOUND_HIT, ASSET_COUNT } AssetId;
+
+// Paths given with "--assets FILE" and "--pack FILE"
+typedef struct AssetOptions
+{
+	const char* packPath; // Pack to load, loose files are used when it doesn't exist
+	const char* writePath; // Build a pack from the loose files and exit, NULL if not given
+} AssetOptions;
+
+// Sprites decoded on a worker thread while the menu is showing
+typedef struct SpriteLoader
+{
+	SDL_Thread* thread; // NULL when the sheet came from the pack or the load has finished
+	SpriteSheet sheet;
+	bool success;
+} SpriteLoader;
+
+#pragma endregion
+
+#pragma region Function declarations
+
+// Parse asset options from the command line
+void parseAssetOptions(int argc, char* argv[], AssetOptions* options);
+
+// Load the pack with a single read, or check that every loose file exists. Prints every missing asset
+bool loadAssets(const char* packPath);
+void freeAssets(void);
+
+// Build a pack from the loose files: the sprite sheet as RGBA, sounds as PCM in the mixer's format and the font file
+bool writeAssetPack(const char* path);
+
+// Access to single assets, from the pack when one was loaded and from loose files otherwise
+SDL_RWops* openFontAsset(void);
+Mix_Chunk* loadSoundAsset(Sound sound);
+
+// Sprites come straight from the pack, loose files are decoded on a worker thread until the sheet is needed
+void startLoadingSprites(SpriteLoader* loader);
+bool finishLoadingSprites(SpriteLoader* loader);
+
+#pragma endregion
@@ -0,0 +1,146 @@
+#include "audio.h"
+
+// Standard libraries
+#include <stdlib.h>
+#include <string.h>
+
+// Mixer buffer in sample frames, about 12 ms at 44100 Hz
+#define DEFAULT_AUDIO_BUFFER 512
+
+// Function for getting the audio options from the command line
+void parseAudioOptions(int argc, char* argv[], AudioOptions* options)
+{
+	options->bufferSize = DEFAULT_AUDIO_BUFFER;
+
+	for (int i = 1; i < argc - 1; i++)
+	{
+		if (strcmp(argv[i], "--audio-buffer") == 0)
+			options->bufferSize = atoi(argv[++i]);
+	}
+
+	// SDL needs a power of two
+	if (options->bufferSize < 64 || options->bufferSize > 8192 || (options->bufferSize & (options->bufferSize - 1)) != 0)
+		options->bufferSize = DEFAULT_AUDIO_BUFFER;
+}
+
+#ifndef HEADLESS
+
+// SDL libraries
+#include <SDL.h>
+#include <SDL_mixer.h>
+
+// Game modules
+#include "assets.h"
+
+// Standard libraries
+#include <stdio.h>
+
+// Loaded sound effects, indexed by Sound
+static Mix_Chunk* sounds[SOUND_COUNT] = { NULL };
+
+// Set while the audio device is open
+static bool audioOpen = false;
+
+// Amount of channels every sound can play on at once. Each sound gets its own group of channels
+static const int soundVoices[SOUND_COUNT] = {
+	[SOUND_SHOOT] = 4,
+	[SOUND_HIT] = 4,
+};
+
+// Sounds requested since the last flush, a sound is played at most once per flush
+static bool pendingSounds[SOUND_COUNT] = { false };
+
+// Function that opens the mixer, sets up the channel groups and loads every sound effect
+bool initAudio(const AudioOptions* options)
+{
+	bool success = true;
+
+	// Initialize the Mix library (audio playback)
+	if (Mix_OpenAudio(AUDIO_FREQUENCY, AUDIO_FORMAT, AUDIO_CHANNELS, options->bufferSize) < 0) {
+		printf("SDL_mixer could not initialize! SDL_mixer Error: %s\n", Mix_GetError());
+		return false;
+	}
+
+	audioOpen = true;
+
+	// Give every sound a fixed range of channels, so one sound can't take all of them
+	int channels = 0;
+	for (int i = 0; i < SOUND_COUNT; i++)
+		channels += soundVoices[i];
+
+	Mix_AllocateChannels(channels);
+
+	int first = 0;
+	for (int i = 0; i < SOUND_COUNT; i++)
+	{
+		Mix_GroupChannels(first, first + soundVoices[i] - 1, i);
+		first += soundVoices[i];
+	}
+
+	// Lower mixer volume
+	Mix_Volume(-1, 64);
+
+	// Load the sound effects, from the asset pack if there is one
+	for (int i = 0; i < SOUND_COUNT; i++)
+	{
+		sounds[i] = loadSoundAsset(i);
+		if (!sounds[i])
+			success = false;
+	}
+
+	return success;
+}
+
+// Free the sound effects and close the mixer
+void quitAudio(void)
+{
+	for (int i = 0; i < SOUND_COUNT; i++)
+	{
+		Mix_FreeChunk(sounds[i]);
+		sounds[i] = NULL;
+	}
+
+	// Freeing a chunk halts the channels playing it, so the device is closed once they're all silent
+	if (audioOpen)
+		Mix_CloseAudio();
+	audioOpen = false;
+
+	Mix_Quit();
+}
+
+// Queue a sound effect, it is played on the next flush
+void playSound(Sound sound)
+{
+	pendingSounds[sound] = true;
+}
+
+// Play every queued sound effect on a free channel of its group, or on the one that has played longest
+void flushAudio(void)
+{
+	for (int i = 0; i < SOUND_COUNT; i++)
+	{
+		if (!pendingSounds[i])
+			continue;
+
+		pendingSounds[i] = false;
+
+		if (!sounds[i])
+			continue;
+
+		int channel = Mix_GroupAvailable(i);
+		if (channel == -1)
+			channel = Mix_GroupOldest(i);
+
+		Mix_PlayChannel(channel, sounds[i], 0);
+	}
+}
+
+#else
+
+// Audio is compiled out of headless builds
+bool initAudio(const AudioOptions* options) { (void)options; return true; }
+void quitAudio(void) {}
+void playSound(Sound sound) { (void)sound; }
+void flushAudio(void) {}
+
+#endif
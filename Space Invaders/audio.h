@@ -0,0 +1,45 @@
+#pragma once
+
+// SDL libraries
+#include <SDL.h>
+
+// Helper libraries
+#include <stdbool.h>
+
+#pragma region ENUMs
+
+// Sound effects that the game can play
+typedef enum Sound { SOUND_SHOOT, SOUND_HIT, SOUND_COUNT } Sound;
+
+// Size given with "--audio-buffer SAMPLES"
+typedef struct AudioOptions
+{
+	int bufferSize; // Mixer buffer in sample frames, a power of two. Smaller means lower latency
+} AudioOptions;
+
+#pragma endregion
+
+#pragma region Globals and defines
+
+// Format the mixer is opened with, and that packed sounds are stored in
+#define AUDIO_FREQUENCY 44100
+#define AUDIO_FORMAT AUDIO_S16SYS
+#define AUDIO_CHANNELS 2
+
+#pragma endregion
+
+#pragma region Function declarations
+
+// Parse audio options from the command line
+void parseAudioOptions(int argc, char* argv[], AudioOptions* options);
+
+// Initialization and exit
+bool initAudio(const AudioOptions* options);
+void quitAudio(void);
+
+// Playback, does nothing when audio hasn't been initialized or is compiled out.
+// Sounds are queued during the simulation and played once per frame, repeats of a sound within a frame are merged
+void playSound(Sound sound);
+void flushAudio(void);
+
+#pragma endregion
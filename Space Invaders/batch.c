@@ -0,0 +1,355 @@
+#include "batch.h"
+
+// Game modules
+#include "game.h"
+#include "logging.h"
+#include "profiler.h"
+
+// Standard libraries
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+// Most worker threads a batch runs on
+#define MAX_BATCH_THREADS 256
+
+#pragma region Structs
+
+struct Batch;
+
+// Worker thread and the range of games it owns. Games are taken one at a time from the front of a range,
+// by the worker that owns it first and by any other worker once its own range has run out
+typedef struct BatchWorker
+{
+	SDL_Thread* thread; // NULL for the first worker, which runs on the calling thread
+	SDL_atomic_t next; // Next game of the range that hasn't been taken
+	int end; // One past the last game of the range
+
+	struct Batch* batch;
+	int index;
+
+	int owner; // Ranges checked for games so far, counting from the worker's own
+	int played; // Amount of games played, stolen ones included
+	int stolen; // Amount of games taken from the ranges of other workers
+} BatchWorker;
+
+// Everything the workers share. Games only write their own result, so nothing but the ranges is contended
+typedef struct Batch
+{
+	const HeadlessOptions* headless;
+	const AgentLibrary* agents; // Policy library when the agent drives the player, every worker makes an agent of its own from it
+
+	BatchGame* games;
+	BatchWorker* workers;
+	int workerCount;
+
+	SDL_atomic_t failed; // Set if a game couldn't be allocated
+} Batch;
+
+#pragma endregion
+
+// Function that parses "--batch N", "--threads N" and "--batch-out FILE"
+bool parseBatchOptions(int argc, char* argv[], BatchOptions* options)
+{
+	options->games = 0;
+	options->threads = 0;
+	options->outputPath = NULL;
+
+	for (int i = 1; i < argc - 1; i++)
+	{
+		if (strcmp(argv[i], "--batch") == 0)
+			options->games = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--threads") == 0)
+			options->threads = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--batch-out") == 0)
+			options->outputPath = argv[++i];
+	}
+
+	return options->games > 0;
+}
+
+// Helper function for keeping how a game ended
+static void recordBatchGame(const Batch* batch, int index, const World* world, unsigned int seed)
+{
+	BatchGame* game = &batch->games[index];
+
+	game->seed = seed;
+	game->ticks = batch->headless->ticks;
+	game->score = world->player.score;
+	game->hiScore = world->player.hiScore;
+	game->wave = world->currentWave;
+	game->livesLeft = world->player.livesLeft;
+	game->hash = hashGameState(world);
+}
+
+// Function that takes the next game nobody has taken, from the worker's own range first and then from the ranges of the others.
+// Returns -1 once every game is taken
+static int takeBatchGame(BatchWorker* worker)
+{
+	Batch* batch = worker->batch;
+
+	for (; worker->owner < batch->workerCount; worker->owner++)
+	{
+		BatchWorker* owner = &batch->workers[(worker->index + worker->owner) % batch->workerCount];
+
+		int game = SDL_AtomicAdd(&owner->next, 1);
+		if (game < owner->end)
+		{
+			worker->played++;
+			if (worker->owner > 0)
+				worker->stolen++;
+
+			return game;
+		}
+	}
+
+	return -1;
+}
+
+// Function that plays one game of the batch from start to end, with a world and a controller of its own
+static bool playBatchGame(const Batch* batch, int index)
+{
+	const HeadlessOptions* headless = batch->headless;
+	unsigned int seed = headless->seed + (unsigned int)index;
+
+	World world;
+	if (!initGame(&world, seed, &headless->game))
+	{
+		quitGame(&world);
+		return false;
+	}
+
+	PolicyState policy;
+	initPolicy(&policy, seed);
+
+	for (Uint64 tick = 0; tick < headless->ticks; tick++)
+	{
+		PlayerInput input;
+		getPolicyInput(headless->policy, &policy, &world, tick, &input);
+
+		update(&world, &input, (float)TICK_TIME);
+	}
+
+	recordBatchGame(batch, index, &world, seed);
+	quitGame(&world);
+
+	return true;
+}
+
+// Function that plays games in groups that step in lockstep, so the agent is called once per tick for a whole group
+// instead of once per tick of every game. Groups are filled from the ranges the same way single games are
+static void playAgentGames(BatchWorker* worker)
+{
+	Batch* batch = worker->batch;
+	const HeadlessOptions* headless = batch->headless;
+	int capacity = headless->agentBatch;
+
+	World* worlds = (World*)calloc((size_t)capacity, sizeof(World));
+	int* indices = (int*)calloc((size_t)capacity, sizeof(int));
+	unsigned int* seeds = (unsigned int*)calloc((size_t)capacity, sizeof(unsigned int));
+	PlayerInput* inputs = (PlayerInput*)calloc((size_t)capacity, sizeof(PlayerInput));
+
+	AgentGroup agent = { NULL };
+
+	// A worker without an agent takes no games, they are left to the other workers
+	if (!worlds || !indices || !seeds || !inputs || !createAgentGroup(&agent, batch->agents, capacity))
+	{
+		printf("Couldn't start batch worker %d with a group of %d games\n", worker->index, capacity);
+		SDL_AtomicSet(&batch->failed, 1);
+	}
+	else
+	{
+		for (;;)
+		{
+			int count = 0;
+
+			while (count < capacity)
+			{
+				int game = takeBatchGame(worker);
+				if (game < 0)
+					break;
+
+				seeds[count] = headless->seed + (unsigned int)game;
+
+				if (!initGame(&worlds[count], seeds[count], &headless->game))
+				{
+					quitGame(&worlds[count]);
+					SDL_AtomicSet(&batch->failed, 1);
+					continue;
+				}
+
+				indices[count++] = game;
+			}
+
+			if (count == 0)
+				break;
+
+			for (Uint64 tick = 0; tick < headless->ticks; tick++)
+			{
+				stepAgentGroup(&agent, worlds, seeds, count, tick, inputs);
+
+				for (int n = 0; n < count; n++)
+					update(&worlds[n], &inputs[n], (float)TICK_TIME);
+			}
+
+			for (int n = 0; n < count; n++)
+			{
+				recordBatchGame(batch, indices[n], &worlds[n], seeds[n]);
+				quitGame(&worlds[n]);
+			}
+		}
+
+		destroyAgentGroup(&agent);
+	}
+
+	free(worlds);
+	free(indices);
+	free(seeds);
+	free(inputs);
+}
+
+// Function that plays the games of its own range, then steals games from the other ranges until every game is taken
+static int batchWorkerThread(void* data)
+{
+	BatchWorker* worker = (BatchWorker*)data;
+	Batch* batch = worker->batch;
+
+	if (batch->agents)
+	{
+		playAgentGames(worker);
+		return 0;
+	}
+
+	int game;
+	while ((game = takeBatchGame(worker)) >= 0)
+	{
+		if (!playBatchGame(batch, game))
+			SDL_AtomicSet(&batch->failed, 1);
+	}
+
+	return 0;
+}
+
+// Helper function for writing the result of every game to a CSV file
+static bool writeBatchGames(const char* path, const BatchGame* games, int count)
+{
+	FILE* file = fopen(path, "w");
+	if (!file)
+	{
+		printf("Couldn't open %s for the batch results\n", path);
+		return false;
+	}
+
+	fprintf(file, "game,seed,ticks,score,hi_score,wave,lives,hash\n");
+
+	for (int i = 0; i < count; i++)
+	{
+		const BatchGame* game = &games[i];
+
+		fprintf(file, "%d,%u,%llu,%d,%d,%d,%d,%08x\n", i, game->seed, (unsigned long long)game->ticks,
+			game->score, game->hiScore, game->wave, game->livesLeft, (unsigned int)game->hash);
+	}
+
+	fclose(file);
+	return true;
+}
+
+// Function that splits the games into a range per worker, plays them on every core and prints the spread of the results
+int runBatch(const BatchOptions* options, const HeadlessOptions* headless)
+{
+	if (headless->policy == POLICY_REPLAY)
+	{
+		printf("A batch can't replay a recording, every game needs a seed of its own\n");
+		return 1;
+	}
+
+	// Loaded once for the whole batch, every worker creates its own agent from it
+	AgentLibrary agents = { NULL };
+	if (headless->policy == POLICY_AGENT && !loadAgentLibrary(&agents, headless->agentPath))
+		return 1;
+
+	// The simulation only reads these flags, so they have to stay off while games run side by side
+	enableLogging(false);
+	setProfiling(false);
+
+	int threads = options->threads > 0 ? options->threads : SDL_GetCPUCount();
+	threads = max(1, min(threads, min(options->games, MAX_BATCH_THREADS)));
+
+	Batch batch = {
+		.headless = headless,
+		.agents = agents.handle ? &agents : NULL,
+		.games = (BatchGame*)calloc((size_t)options->games, sizeof(BatchGame)),
+		.workers = (BatchWorker*)calloc((size_t)threads, sizeof(BatchWorker)),
+		.workerCount = threads,
+	};
+
+	if (!batch.games || !batch.workers)
+	{
+		printf("Couldn't allocate a batch of %d games\n", options->games);
+		free(batch.games);
+		free(batch.workers);
+		unloadAgentLibrary(&agents);
+		return 1;
+	}
+
+	SDL_AtomicSet(&batch.failed, 0);
+
+	for (int w = 0; w < threads; w++)
+	{
+		BatchWorker* worker = &batch.workers[w];
+
+		worker->batch = &batch;
+		worker->index = w;
+		worker->end = (int)((Sint64)options->games * (w + 1) / threads);
+
+		SDL_AtomicSet(&worker->next, (int)((Sint64)options->games * w / threads));
+	}
+
+	Uint64 frequency = SDL_GetPerformanceFrequency();
+	Uint64 start = SDL_GetPerformanceCounter();
+
+	// A worker that couldn't be started leaves its range to be stolen by the others
+	for (int w = 1; w < threads; w++)
+		batch.workers[w].thread = SDL_CreateThread(batchWorkerThread, "Batch worker", &batch.workers[w]);
+
+	batchWorkerThread(&batch.workers[0]);
+
+	for (int w = 1; w < threads; w++)
+		SDL_WaitThread(batch.workers[w].thread, NULL);
+
+	double seconds = (double)(SDL_GetPerformanceCounter() - start) / (double)frequency;
+
+	// Spread of the scores and waves over every game
+	int minScore = batch.games[0].score, maxScore = batch.games[0].score;
+	double scoreSum = 0.0, waveSum = 0.0;
+	int stolen = 0;
+
+	for (int i = 0; i < options->games; i++)
+	{
+		minScore = min(minScore, batch.games[i].score);
+		maxScore = max(maxScore, batch.games[i].score);
+		scoreSum += batch.games[i].score;
+		waveSum += batch.games[i].wave;
+	}
+
+	for (int w = 0; w < threads; w++)
+		stolen += batch.workers[w].stolen;
+
+	double ticks = (double)options->games * (double)headless->ticks;
+
+	printf("Batch run: %d games of %llu ticks on %d threads in %.3f s, %.0f ticks/s, %d games stolen\n",
+		options->games, (unsigned long long)headless->ticks, threads, seconds, seconds > 0 ? ticks / seconds : 0.0, stolen);
+	printf("Score: avg %.1f, min %d, max %d, Wave: avg %.2f\n",
+		scoreSum / options->games, minScore, maxScore, waveSum / options->games);
+
+	bool success = SDL_AtomicGet(&batch.failed) == 0;
+
+	if (options->outputPath && !writeBatchGames(options->outputPath, batch.games, options->games))
+		success = false;
+
+	free(batch.games);
+	free(batch.workers);
+	unloadAgentLibrary(&agents);
+
+	return success ? 0 : 1;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+// SDL libraries
+#include <SDL.h>
+
+// Game modules
+#include "headless.h"
+
+// Helper libraries
+#include <stdbool.h>
+
+#pragma region Structs and ENUMs
+
+// Size of a batch given with "--batch N", "--threads N" and "--batch-out FILE"
+typedef struct BatchOptions
+{
+	int games; // Amount of independent games
+	int threads; // Worker threads, every core if not given
+	const char* outputPath; // CSV with a line per game, NULL if not given
+} BatchOptions;
+
+// How a game of a batch ended
+typedef struct BatchGame
+{
+	unsigned int seed; // Seed of the game and of its controller
+	Uint64 ticks; // Amount of ticks simulated
+	int score, hiScore; // Score of the current game, and the best of the games before it
+	int wave, livesLeft;
+	Uint32 hash; // Hash of the state it ended in
+} BatchGame;
+
+#pragma endregion
+
+#pragma region Function declarations
+
+// Parse batch options from the command line. Returns false if a batch wasn't requested
+bool parseBatchOptions(int argc, char* argv[], BatchOptions* options);
+
+// Simulate many games on every core and print a summary. Game N uses the headless seed plus N, and the headless controller, ticks and config
+int runBatch(const BatchOptions* options, const HeadlessOptions* headless);
+
+#pragma endregion
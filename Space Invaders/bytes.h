@@ -0,0 +1,49 @@
+#pragma once
+
+// SDL libraries
+#include <SDL.h>
+
+// Standard libraries
+#include <stddef.h>
+
+#pragma region Defines
+
+// Start of an FNV-1a hash, and the prime every byte is multiplied in with
+#define FNV_OFFSET_BASIS 2166136261u
+#define FNV_PRIME 16777619u
+
+#pragma endregion
+
+#pragma region Inline functions
+
+// Write an integer of the given amount of bytes in little-endian order
+static inline void writeLittleEndian(Uint8* out, Uint64 value, int bytes)
+{
+	for (int i = 0; i < bytes; i++)
+		out[i] = (Uint8)(value >> (8 * i));
+}
+
+// Read an integer of the given amount of bytes in little-endian order
+static inline Uint64 readLittleEndian(const Uint8* in, int bytes)
+{
+	Uint64 value = 0;
+	for (int i = 0; i < bytes; i++)
+		value |= (Uint64)in[i] << (8 * i);
+	return value;
+}
+
+// Add bytes to an FNV-1a hash, a new hash starts from FNV_OFFSET_BASIS
+static inline Uint32 hashBytes(Uint32 hash, const void* data, size_t size)
+{
+	const Uint8* bytes = (const Uint8*)data;
+
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= bytes[i];
+		hash *= FNV_PRIME;
+	}
+
+	return hash;
+}
+
+#pragma endregion
@@ -0,0 +1,83 @@
+#include "collision.h"
+
+// Standard libraries
+#include <string.h>
+
+// Helper function for mapping a coordinate to a cell, clamped to the grid
+static inline int toCell(float coordinate, float cellSize, int cells)
+{
+	int cell = (int)(coordinate / cellSize);
+
+	if (coordinate < 0 || cell < 0)
+		return 0;
+
+	return cell < cells ? cell : cells - 1;
+}
+
+// Function for getting the size of the block holding the cells and items of a grid covering the given area
+size_t getCollisionGridSize(float width, float height, float cellSize, int capacity)
+{
+	size_t cells = (size_t)((int)(width / cellSize) + 1) * (size_t)((int)(height / cellSize) + 1);
+
+	return sizeof(int) * (cells + 1 + (size_t)capacity) + sizeof(float) * (size_t)capacity * 2;
+}
+
+// Function that points the cells and items of a grid into a block, without touching its contents
+void bindCollisionGrid(CollisionGrid* grid, void* memory, float width, float height, float cellSize, int capacity)
+{
+	grid->cellSize = cellSize;
+	grid->cols = (int)(width / cellSize) + 1;
+	grid->rows = (int)(height / cellSize) + 1;
+
+	grid->cellStart = (int*)memory;
+	grid->items = grid->cellStart + grid->cols * grid->rows + 1;
+	grid->itemPx = (float*)(grid->items + capacity);
+	grid->itemPy = grid->itemPx + capacity;
+}
+
+// Function that sorts the live entities of a store into the grid cells with a counting sort
+void buildCollisionGrid(CollisionGrid* grid, const EntityStore* store)
+{
+	int cells = grid->cols * grid->rows;
+	memset(grid->cellStart, 0, sizeof(int) * ((size_t)cells + 1));
+
+	// Count the entities of every cell, shifted by one so the prefix sum gives the start of each cell
+	for (int n = 0; n < store->count; n++)
+	{
+		int i = store->live[n];
+		int cell = toCell(store->py[i], grid->cellSize, grid->rows) * grid->cols + toCell(store->px[i], grid->cellSize, grid->cols);
+
+		grid->cellStart[cell + 1]++;
+	}
+
+	for (int c = 0; c < cells; c++)
+		grid->cellStart[c + 1] += grid->cellStart[c];
+
+	// Place every entity, using the start of the next cell as a running cursor
+	for (int n = 0; n < store->count; n++)
+	{
+		int i = store->live[n];
+		int cell = toCell(store->py[i], grid->cellSize, grid->rows) * grid->cols + toCell(store->px[i], grid->cellSize, grid->cols);
+
+		int k = grid->cellStart[cell]++;
+
+		// The coordinates are copied next to each other, so the items of a row of cells can be tested several at a time
+		grid->items[k] = i;
+		grid->itemPx[k] = store->px[i];
+		grid->itemPy[k] = store->py[i];
+	}
+
+	// Every cursor now points at the end of its cell, shift them back to the start
+	for (int c = cells; c > 0; c--)
+		grid->cellStart[c] = grid->cellStart[c - 1];
+	grid->cellStart[0] = 0;
+}
+
+// Function that clamps an area to the grid and returns the cells it covers
+void getGridCellRange(const CollisionGrid* grid, float x0, float y0, float x1, float y1, int* cx0, int* cy0, int* cx1, int* cy1)
+{
+	*cx0 = toCell(x0, grid->cellSize, grid->cols);
+	*cy0 = toCell(y0, grid->cellSize, grid->rows);
+	*cx1 = toCell(x1, grid->cellSize, grid->cols);
+	*cy1 = toCell(y1, grid->cellSize, grid->rows);
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+// Game modules
+#include "entities.h"
+
+// Helper libraries
+#include <stdbool.h>
+
+#pragma region Structs
+
+// Uniform grid used as a broad phase for collisions against one entity store.
+// Entities are bucketed by the cell of their top-left corner.
+typedef struct CollisionGrid
+{
+	float cellSize; // Width and height of a cell, at least the size of the largest entity
+	int cols, rows; // Amount of cells
+
+	int* cellStart; // Index of the first item of every cell, with one extra entry marking the end
+	int* items; // Slots of the entities, sorted by cell
+	float* itemPx, * itemPy; // Coordinates of the entities when the grid was built, in the same order as the items
+} CollisionGrid;
+
+#pragma endregion
+
+#pragma region Function declarations
+
+// Placement inside memory owned by someone else. Binding only sets the pointers, so a copied block can be bound again
+size_t getCollisionGridSize(float width, float height, float cellSize, int capacity);
+void bindCollisionGrid(CollisionGrid* grid, void* memory, float width, float height, float cellSize, int capacity);
+
+// Bucket every live entity of the store into the grid
+void buildCollisionGrid(CollisionGrid* grid, const EntityStore* store);
+
+// Get the range of cells that can contain an entity whose top-left corner lies inside the given area (inclusive)
+void getGridCellRange(const CollisionGrid* grid, float x0, float y0, float x1, float y1, int* cx0, int* cy0, int* cx1, int* cy1);
+
+#pragma endregion
+
+#pragma region Inline helpers
+
+// Get the first and one past the last item of a cell
+static inline void getGridCell(const CollisionGrid* grid, int cx, int cy, int* first, int* last)
+{
+	int cell = cy * grid->cols + cx;
+
+	*first = grid->cellStart[cell];
+	*last = grid->cellStart[cell + 1];
+}
+
+#pragma endregion
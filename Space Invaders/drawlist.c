@@ -0,0 +1,254 @@
+#include "drawlist.h"
+
+// Standard libraries
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+// Function that allocates every list of a queue, each fitting the given amount of sprites
+bool createDrawQueue(DrawQueue* queue, int capacity)
+{
+	memset(queue, 0, sizeof *queue);
+
+	bool success = true;
+
+	for (int n = 0; n < DRAW_LIST_COUNT; n++)
+	{
+		queue->lists[n].sprites = (DrawSprite*)malloc(sizeof(DrawSprite) * (size_t)capacity);
+		queue->lists[n].capacity = capacity;
+
+		if (!queue->lists[n].sprites)
+			success = false;
+	}
+
+	queue->writing = 0;
+	queue->ready = 1;
+	queue->drawing = 2;
+
+	queue->lock = SDL_CreateMutex();
+	queue->published = SDL_CreateCond();
+	queue->taken = SDL_CreateCond();
+
+	if (!queue->lock || !queue->published || !queue->taken)
+		success = false;
+
+	if (!success)
+	{
+		printf("Couldn't create the draw queue: %s\n", SDL_GetError());
+		freeDrawQueue(queue);
+	}
+
+	return success;
+}
+
+// Free every list of a queue. The render thread has to be done with it
+void freeDrawQueue(DrawQueue* queue)
+{
+	for (int n = 0; n < DRAW_LIST_COUNT; n++)
+		free(queue->lists[n].sprites);
+
+	SDL_DestroyCond(queue->taken);
+	SDL_DestroyCond(queue->published);
+	SDL_DestroyMutex(queue->lock);
+
+	memset(queue, 0, sizeof *queue);
+}
+
+// Function for getting the list the simulation fills next, emptied
+DrawList* beginDrawList(DrawQueue* queue)
+{
+	DrawList* list = &queue->lists[queue->writing];
+
+	list->count = 0;
+	list->inputTime = 0;
+
+	return list;
+}
+
+// Function that makes the filled list the newest finished one. A finished list that wasn't taken is filled next instead
+void publishDrawList(DrawQueue* queue)
+{
+	SDL_LockMutex(queue->lock);
+
+	DrawList* list = &queue->lists[queue->writing];
+	const DrawList* dropped = &queue->lists[queue->ready];
+
+	if (queue->pending)
+	{
+		queue->dropped++;
+
+		// The frame also shows the result of the input of the list it replaces, so the oldest input time carries over
+		if (dropped->inputTime != 0 && (list->inputTime == 0 || dropped->inputTime < list->inputTime))
+			list->inputTime = dropped->inputTime;
+	}
+
+	int ready = queue->ready;
+	queue->ready = queue->writing;
+	queue->writing = ready;
+	queue->pending = true;
+
+	SDL_UnlockMutex(queue->lock);
+	SDL_CondSignal(queue->published);
+}
+
+// Function that waits until the render thread has taken the newest list, so the simulation is never more than a frame ahead of it
+bool waitForDrawListTaken(DrawQueue* queue, Uint32 timeout)
+{
+	if (!queue->lock)
+		return true;
+
+	bool taken = true;
+
+	SDL_LockMutex(queue->lock);
+
+	while (queue->pending && !queue->stopped)
+	{
+		if (SDL_CondWaitTimeout(queue->taken, queue->lock, timeout) == SDL_MUTEX_TIMEDOUT)
+		{
+			taken = false;
+			break;
+		}
+	}
+
+	SDL_UnlockMutex(queue->lock);
+
+	return taken;
+}
+
+// Function that waits for a finished list and swaps it with the one drawn last
+const DrawList* takeDrawList(DrawQueue* queue)
+{
+	SDL_LockMutex(queue->lock);
+
+	while (!queue->pending && !queue->stopped)
+		SDL_CondWait(queue->published, queue->lock);
+
+	if (queue->stopped)
+	{
+		SDL_UnlockMutex(queue->lock);
+		return NULL;
+	}
+
+	int drawing = queue->drawing;
+	queue->drawing = queue->ready;
+	queue->ready = drawing;
+	queue->pending = false;
+
+	SDL_UnlockMutex(queue->lock);
+	SDL_CondSignal(queue->taken);
+
+	return &queue->lists[queue->drawing];
+}
+
+// Function that stops the queue and wakes up whoever is waiting on it
+void stopDrawQueue(DrawQueue* queue)
+{
+	if (!queue->lock)
+		return;
+
+	SDL_LockMutex(queue->lock);
+	queue->stopped = true;
+	SDL_UnlockMutex(queue->lock);
+
+	SDL_CondBroadcast(queue->published);
+	SDL_CondBroadcast(queue->taken);
+}
+
+// Helper function for blending between the coordinates of the last two ticks
+static inline float interpolate(float last, float current, float alpha)
+{
+	return last + (current - last) * alpha;
+}
+
+// Helper function for adding a sprite to a list, sprites beyond its capacity are dropped
+static inline void addDrawSprite(DrawList* list, SpriteId sprite, float progress, float px, float py, float w, float h, SDL_Color color)
+{
+	if (list->count >= list->capacity)
+		return;
+
+	list->sprites[list->count++] = (DrawSprite){
+		.sprite = sprite,
+		.progress = progress,
+		.px = px, .py = py,
+		.w = w, .h = h,
+		.color = color,
+	};
+}
+
+// Function that copies everything a frame shows out of the world, in the order it's drawn
+void buildDrawList(DrawList* list, const World* world, float alpha)
+{
+	list->playGame = world->playGame;
+	list->score = world->player.score;
+	list->hiScore = world->player.hiScore;
+	list->livesLeft = world->player.livesLeft;
+	list->wave = world->currentWave;
+
+	if (!world->playGame)
+		return;
+
+	SDL_Color green = { 0, 255, 0, 255 };
+	SDL_Color white = { 255, 255, 255, 255 };
+
+	// Snap to whole pixels to keep the pixel art crisp
+	addDrawSprite(list, SPRITE_PLAYER, 0.0f,
+		SDL_floorf(interpolate(world->player.lastPx, world->player.px, alpha)),
+		SDL_floorf(interpolate(world->player.lastPy, world->player.py, alpha)),
+		tunables.playerWidth, tunables.playerHeight, green);
+
+	// The co-op partner is told apart by its colour
+	if (world->config.players == 2)
+	{
+		SDL_Color cyan = { 0, 255, 255, 255 };
+
+		addDrawSprite(list, SPRITE_PLAYER, 0.0f,
+			SDL_floorf(interpolate(world->partner.lastPx, world->partner.px, alpha)),
+			SDL_floorf(interpolate(world->partner.lastPy, world->partner.py, alpha)),
+			tunables.playerWidth, tunables.playerHeight, cyan);
+	}
+
+	const EntityStore* enemies = &world->enemies;
+	const EntityStore* bullets = &world->bullets;
+	const ParticleEmitter* particles = &world->particles;
+
+	float formationX = interpolate(world->formation.lastPx, world->formation.px, alpha);
+	float formationY = interpolate(world->formation.lastPy, world->formation.py, alpha);
+
+	for (int n = 0; n < enemies->count; n++)
+	{
+		int i = enemies->live[n];
+
+		addDrawSprite(list, SPRITE_ENEMY, 0.0f,
+			SDL_floorf(formationX + enemies->px[i]),
+			SDL_floorf(formationY + enemies->py[i]),
+			tunables.enemyWidth, tunables.enemyHeight, white);
+	}
+
+	for (int n = 0; n < bullets->count; n++)
+	{
+		int i = bullets->live[n];
+
+		addDrawSprite(list, SPRITE_BULLET, 0.0f,
+			SDL_floorf(interpolate(bullets->lastPx[i], bullets->px[i], alpha)),
+			SDL_floorf(interpolate(bullets->lastPy[i], bullets->py[i], alpha)),
+			tunables.bulletWidth, tunables.bulletHeight, white);
+	}
+
+	for (int n = 0; n < particles->count; n++)
+	{
+		int i = getParticleSlot(particles, n);
+
+		// Particles move in a straight line, and fade and animate over their lifetime
+		float age = getParticleAge(particles, i, alpha);
+		float life = age / (float)particles->lifetime;
+		float seconds = age * (float)TICK_TIME;
+
+		SDL_Color fade = { 255, 255, 255, (Uint8)(255.0f * (1.0f - life)) };
+
+		// Particle types map directly onto the explosion sprites
+		addDrawSprite(list, (SpriteId)(SPRITE_BULLET_EXPLOSION + particles->type[i]), life,
+			SDL_floorf(particles->px[i] + particles->vx[i] * seconds),
+			SDL_floorf(particles->py[i] + particles->vy[i] * seconds),
+			particles->size[i], particles->size[i], fade);
+	}
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+// SDL libraries
+#include <SDL.h>
+
+// Game modules
+#include "game.h"
+#include "pacing.h"
+#include "sprites.h"
+
+// Helper libraries
+#include <stdbool.h>
+
+#pragma region Structs and defines
+
+// Lists a queue cycles through: the one being filled, the newest finished one and the one being drawn
+#define DRAW_LIST_COUNT 3
+
+// A sprite as the render thread draws it, already interpolated and snapped to whole pixels
+typedef struct DrawSprite
+{
+	SpriteId sprite;
+	float progress; // How far its animation has played, from 0 to 1
+	float px, py, w, h;
+	SDL_Color color;
+} DrawSprite;
+
+// Everything a frame shows, copied out of the world so the render thread never reads it
+typedef struct DrawList
+{
+	DrawSprite* sprites;
+	int count, capacity;
+
+	bool playGame; // The game is drawn if true, the menu otherwise
+	int score, hiScore, livesLeft, wave;
+
+	PresentMode presentMode; // The render thread switches vsync when this changes
+	bool showProfiler;
+
+	Uint64 inputTime; // Oldest input event the frame is the first to show the result of, 0 if there is none
+} DrawList;
+
+// Lists handed from the simulation to the render thread. Only the newest finished list is kept, one that
+// wasn't taken before the next was finished is filled again without being drawn
+typedef struct DrawQueue
+{
+	DrawList lists[DRAW_LIST_COUNT];
+
+	int writing; // Being filled, only touched by the simulation
+	int ready; // Newest finished list
+	int drawing; // Being drawn, only touched by the render thread
+
+	bool pending; // Whether the ready list hasn't been taken yet
+	int dropped; // Lists that were filled again before being taken, only touched by the simulation
+	bool stopped;
+
+	SDL_mutex* lock;
+	SDL_cond* published; // Signalled when a list is finished, or the queue stops
+	SDL_cond* taken; // Signalled when the render thread takes a list, or the queue stops
+} DrawQueue;
+
+#pragma endregion
+
+#pragma region Function declarations
+
+// Creation, every list fits the given amount of sprites
+bool createDrawQueue(DrawQueue* queue, int capacity);
+void freeDrawQueue(DrawQueue* queue);
+
+// Simulation side: fill the list returned by begin, then publish it
+DrawList* beginDrawList(DrawQueue* queue);
+void publishDrawList(DrawQueue* queue);
+
+// Wait until the last published list has been taken, or the timeout runs out. Returns false on a timeout
+bool waitForDrawListTaken(DrawQueue* queue, Uint32 timeout);
+
+// Render thread side: wait for a list that hasn't been drawn yet. Returns NULL once the queue stops
+const DrawList* takeDrawList(DrawQueue* queue);
+
+// Wake up both sides for good, the render thread gets NULL from then on
+void stopDrawQueue(DrawQueue* queue);
+
+// Fill a list with every sprite and HUD value of the world, alpha is how far the frame is between the last two ticks
+void buildDrawList(DrawList* list, const World* world, float alpha);
+
+#pragma endregion
@@ -0,0 +1,128 @@
+#include "entities.h"
+
+// Standard libraries
+#include <string.h>
+
+// Amount of 32-bit words needed for the alive bitmask
+#define MASK_WORDS(capacity) (((capacity) + 31) / 32)
+
+// Function for getting the size of the block holding every array of an entity store
+size_t getEntityStoreSize(int capacity)
+{
+	size_t floats = sizeof(float) * (size_t)capacity * 5;
+	size_t ints = sizeof(int) * (size_t)capacity * 3;
+	size_t mask = sizeof(Uint32) * (size_t)MASK_WORDS(capacity);
+
+	return floats + ints + mask;
+}
+
+// Function that points the arrays of an entity store into a block, without touching its contents
+void bindEntityStore(EntityStore* store, void* memory, int capacity)
+{
+	char* block = (char*)memory;
+
+	size_t floats = sizeof(float) * (size_t)capacity * 5;
+	size_t ints = sizeof(int) * (size_t)capacity * 3;
+
+	store->capacity = capacity;
+
+	store->px = (float*)block;
+	store->py = store->px + capacity;
+	store->lastPx = store->py + capacity;
+	store->lastPy = store->lastPx + capacity;
+	store->timer = store->lastPy + capacity;
+
+	store->tag = (int*)(block + floats);
+	store->live = store->tag + capacity;
+	store->livePos = store->live + capacity;
+
+	store->alive = (Uint32*)(block + floats + ints);
+}
+
+// Function that starts an entity store out empty
+void initEntityStore(EntityStore* store)
+{
+	// Every slot starts out in the free part of the live list
+	for (int i = 0; i < store->capacity; i++)
+	{
+		store->live[i] = i;
+		store->livePos[i] = i;
+	}
+
+	resetEntityStore(store);
+}
+
+// Kill every entity. The live list stays a valid permutation, so only the count and the bitmask are cleared
+void resetEntityStore(EntityStore* store)
+{
+	store->count = 0;
+
+	if (store->alive)
+		memset(store->alive, 0, sizeof(Uint32) * (size_t)MASK_WORDS(store->capacity));
+}
+
+// Copy the coordinates of every slot, a straight copy is cheaper than walking the live list
+void saveEntityPositions(EntityStore* store)
+{
+	memcpy(store->lastPx, store->px, sizeof(float) * (size_t)store->capacity);
+	memcpy(store->lastPy, store->py, sizeof(float) * (size_t)store->capacity);
+}
+
+// Clear the values a dead entity left in the slot, so a new entity never starts from stale data
+static void clearEntity(EntityStore* store, int slot)
+{
+	store->px[slot] = store->py[slot] = 0.0f;
+	store->lastPx[slot] = store->lastPy[slot] = 0.0f;
+	store->timer[slot] = 0.0f;
+	store->tag[slot] = 0;
+}
+
+// Spawn an entity in any free slot. Returns the slot, or -1 if the store is full
+int spawnEntity(EntityStore* store)
+{
+	if (store->count >= store->capacity)
+		return -1;
+
+	int slot = store->live[store->count++];
+	store->alive[slot >> 5] |= 1u << (slot & 31);
+	clearEntity(store, slot);
+
+	return slot;
+}
+
+// Spawn an entity in a specific slot. Returns the slot, or -1 if it is already in use
+int spawnEntityAt(EntityStore* store, int slot)
+{
+	int pos = store->livePos[slot];
+	if (pos < store->count)
+		return -1;
+
+	// Swap the slot to the end of the live part of the list
+	int other = store->live[store->count];
+	store->live[store->count] = slot;
+	store->livePos[slot] = store->count;
+	store->live[pos] = other;
+	store->livePos[other] = pos;
+
+	store->count++;
+	store->alive[slot >> 5] |= 1u << (slot & 31);
+	clearEntity(store, slot);
+
+	return slot;
+}
+
+// Kill the entity in the given slot by swapping it with the last live entity
+void killEntity(EntityStore* store, int slot)
+{
+	int pos = store->livePos[slot];
+	if (pos >= store->count)
+		return;
+
+	int last = store->live[--store->count];
+	store->live[pos] = last;
+	store->livePos[last] = pos;
+	store->live[store->count] = slot;
+	store->livePos[slot] = store->count;
+
+	store->alive[slot >> 5] &= ~(1u << (slot & 31));
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+// SDL libraries
+#include <SDL.h>
+
+// Helper libraries
+#include <stdbool.h>
+
+#pragma region Structs
+
+// Structure-of-arrays storage for one kind of entity.
+// Slots never move, the live slots are additionally kept in a dense list so loops only touch live entities.
+typedef struct EntityStore
+{
+	int capacity; // Maximum amount of entities
+	int count; // Amount of live entities
+
+	float* px, * py; // Coordinates
+	float* lastPx, * lastPy; // Coordinates at the start of the current tick, used for interpolating between ticks
+	float* timer; // Shooting cooldown for enemies
+	int* tag; // Kill reward for enemies, Y-velocity for bullets
+
+	Uint32* alive; // Bitmask of live slots, one bit per slot
+
+	int* live; // Dense list of slots, the first count entries are alive
+	int* livePos; // Position of every slot in the live list
+} EntityStore;
+
+#pragma endregion
+
+#pragma region Function declarations
+
+// Placement inside memory owned by someone else. Binding only sets the pointers, so a copied block can be bound again
+size_t getEntityStoreSize(int capacity);
+void bindEntityStore(EntityStore* store, void* memory, int capacity);
+void initEntityStore(EntityStore* store);
+
+// Constant time reset, kills every entity
+void resetEntityStore(EntityStore* store);
+
+// Remember the current coordinates before a simulation tick moves them
+void saveEntityPositions(EntityStore* store);
+
+// Spawning and killing
+int spawnEntity(EntityStore* store);
+int spawnEntityAt(EntityStore* store, int slot);
+void killEntity(EntityStore* store, int slot);
+
+#pragma endregion
+
+#pragma region Inline helpers
+
+// Check if the entity in the given slot is alive
+static inline bool isEntityAlive(const EntityStore* store, int slot)
+{
+	return (store->alive[slot >> 5] >> (slot & 31)) & 1u;
+}
+
+#pragma endregion
@@ -0,0 +1,164 @@
+#include "formation.h"
+
+// Standard libraries
+#include <string.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// Amount of 32-bit words needed for a bitmask
+#define MASK_WORDS(bits) (((bits) + 31) / 32)
+
+// Index of the lowest set bit, the word must not be zero
+static inline int findFirstBit(Uint32 word)
+{
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward(&index, word);
+	return (int)index;
+#else
+	return __builtin_ctz(word);
+#endif
+}
+
+// Index of the highest set bit, the word must not be zero
+static inline int findLastBit(Uint32 word)
+{
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanReverse(&index, word);
+	return (int)index;
+#else
+	return 31 - __builtin_clz(word);
+#endif
+}
+
+// Helper function for finding the first set bit of a mask
+static int scanForward(const Uint32* mask, int bits)
+{
+	for (int w = 0; w < MASK_WORDS(bits); w++)
+		if (mask[w])
+			return w * 32 + findFirstBit(mask[w]);
+
+	return -1;
+}
+
+// Helper function for finding the last set bit of a mask
+static int scanReverse(const Uint32* mask, int bits)
+{
+	for (int w = MASK_WORDS(bits) - 1; w >= 0; w--)
+		if (mask[w])
+			return w * 32 + findLastBit(mask[w]);
+
+	return -1;
+}
+
+// Helper function for setting the first bits of a mask and clearing the rest
+static void fillMask(Uint32* mask, int bits)
+{
+	memset(mask, 0, sizeof(Uint32) * (size_t)MASK_WORDS(bits));
+
+	for (int w = 0; w < bits / 32; w++)
+		mask[w] = 0xFFFFFFFFu;
+
+	if (bits % 32)
+		mask[bits / 32] = (1u << (bits % 32)) - 1;
+}
+
+// Function for getting the size of the block holding the counters and masks of a formation
+size_t getFormationSize(int cols, int rows)
+{
+	size_t counts = sizeof(int) * ((size_t)cols * 2 + (size_t)rows);
+	size_t masks = sizeof(Uint32) * ((size_t)MASK_WORDS(cols) + (size_t)MASK_WORDS(rows) + (size_t)MASK_WORDS(cols * rows));
+
+	return counts + masks;
+}
+
+// Function that points the counters and masks of a formation into a block, without touching its contents
+void bindFormation(Formation* formation, void* memory, int cols, int rows)
+{
+	char* block = (char*)memory;
+
+	size_t counts = sizeof(int) * ((size_t)cols * 2 + (size_t)rows);
+
+	formation->cols = cols;
+	formation->rows = rows;
+
+	formation->columnCount = (int*)block;
+	formation->rowCount = formation->columnCount + cols;
+	formation->bottomRow = formation->rowCount + rows;
+	formation->columnMask = (Uint32*)(block + counts);
+	formation->rowMask = formation->columnMask + MASK_WORDS(cols);
+	formation->cellMask = formation->rowMask + MASK_WORDS(rows);
+}
+
+// Function that brings every enemy of the formation back to life at the given origin
+void resetFormation(Formation* formation, float px, float py)
+{
+	formation->px = formation->lastPx = px;
+	formation->py = formation->lastPy = py;
+
+	for (int c = 0; c < formation->cols; c++)
+	{
+		formation->columnCount[c] = formation->rows;
+		formation->bottomRow[c] = formation->rows - 1;
+	}
+
+	for (int r = 0; r < formation->rows; r++)
+		formation->rowCount[r] = formation->cols;
+
+	fillMask(formation->columnMask, formation->cols);
+	fillMask(formation->rowMask, formation->rows);
+	fillMask(formation->cellMask, formation->cols * formation->rows);
+}
+
+// Function that updates the counters of a column and row, clearing their bit once they are empty,
+// and moves the bottom of the column up to the next live cell if the bottom cell died
+bool killFormationCell(Formation* formation, int col, int row)
+{
+	int cell = row * formation->cols + col;
+	formation->cellMask[cell >> 5] &= ~(1u << (cell & 31));
+
+	if (--formation->columnCount[col] == 0)
+		formation->columnMask[col >> 5] &= ~(1u << (col & 31));
+
+	if (--formation->rowCount[row] == 0)
+		formation->rowMask[row >> 5] &= ~(1u << (row & 31));
+
+	if (formation->bottomRow[col] != row)
+		return false;
+
+	// Walk up the column, only the cells above the old bottom can still be alive
+	int bottom = row - 1;
+	while (bottom >= 0)
+	{
+		cell -= formation->cols;
+		if ((formation->cellMask[cell >> 5] >> (cell & 31)) & 1u)
+			break;
+
+		bottom--;
+	}
+
+	formation->bottomRow[col] = bottom;
+
+	return true;
+}
+
+// Get the leftmost column with a live enemy
+int getLeftmostColumn(const Formation* formation)
+{
+	return scanForward(formation->columnMask, formation->cols);
+}
+
+// Get the rightmost column with a live enemy
+int getRightmostColumn(const Formation* formation)
+{
+	return scanReverse(formation->columnMask, formation->cols);
+}
+
+// Get the lowest row with a live enemy
+int getBottomRow(const Formation* formation)
+{
+	return scanReverse(formation->rowMask, formation->rows);
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+// SDL libraries
+#include <SDL.h>
+
+// Helper libraries
+#include <stdbool.h>
+
+#pragma region Structs
+
+// Enemy formation that moves as one rigid body. Enemies only store their offset from the origin,
+// and which columns and rows still have live enemies is tracked with counters and bitmasks.
+typedef struct Formation
+{
+	float px, py; // Origin, the top-left corner of the first column and row
+	float lastPx, lastPy; // Origin at the start of the current tick, used for interpolation
+
+	int cols, rows; // Size of the formation
+
+	int* columnCount; // Amount of live enemies in every column
+	int* rowCount; // Amount of live enemies in every row
+
+	Uint32* columnMask; // Bit set for every column that still has a live enemy
+	Uint32* rowMask; // Bit set for every row that still has a live enemy
+	Uint32* cellMask; // Bit set for every live cell, indexed by row * cols + col
+
+	int* bottomRow; // Lowest live row of every column, -1 once the column is empty
+} Formation;
+
+#pragma endregion
+
+#pragma region Function declarations
+
+// Placement inside memory owned by someone else. Binding only sets the pointers, so a copied block can be bound again
+size_t getFormationSize(int cols, int rows);
+void bindFormation(Formation* formation, void* memory, int cols, int rows);
+
+// Mark every cell as alive and move the origin
+void resetFormation(Formation* formation, float px, float py);
+
+// Mark the cell at the given column and row as dead. Returns true if the bottom row of the column changed
+bool killFormationCell(Formation* formation, int col, int row);
+
+// Edges of the live part of the formation, -1 if every enemy is dead
+int getLeftmostColumn(const Formation* formation);
+int getRightmostColumn(const Formation* formation);
+int getBottomRow(const Formation* formation);
+
+#pragma endregion
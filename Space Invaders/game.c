@@ -0,0 +1,767 @@
+#include "game.h"
+
+// Game modules
+#include "audio.h"
+#include "bytes.h"
+#include "collision.h"
+#include "kernels.h"
+#include "logging.h"
+#include "profiler.h"
+#include "rng.h"
+
+// Standard libraries
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#pragma region Globals
+
+// Look of every type of explosion: a flash where it happened and debris flying apart from it
+typedef struct ExplosionStyle
+{
+	int debris; // Amount of debris particles
+	float minSpeed, maxSpeed; // Speed range of the debris in pixels per second
+	float debrisSize; // Width and height of the debris
+} ExplosionStyle;
+
+static const ExplosionStyle explosionStyles[] = {
+	[BULLET_EXPLOSION] = { .debris = 6, .minSpeed = 30.0f, .maxSpeed = 70.0f, .debrisSize = 5.0f },
+	[SHIP_EXPLOSION] = { .debris = 16, .minSpeed = 40.0f, .maxSpeed = 140.0f, .debrisSize = 7.0f },
+};
+
+// The world that is played and rendered
+World gameWorld;
+
+#pragma endregion
+
+// Helper function for asking for a sound, it is played once the frame is done
+static inline void requestSound(World* world, Sound sound)
+{
+	world->sounds |= 1u << sound;
+}
+
+// Function for getting the size of the game from the command line
+bool parseGameConfig(int argc, char* argv[], GameConfig* config)
+{
+	// Loaded once and shared by every world played with the config, worlds copy it when they are initialized
+	static WaveSchedule authoredWaves;
+
+	bool changed = false;
+
+	config->formationCols = FORMATION_COLS;
+	config->formationRows = FORMATION_ROWS;
+	config->maxBullets = MAX_PROJECTILES;
+	config->maxParticles = MAX_PARTICLES;
+	config->enemyFireRate = tunables.enemyFireRate;
+	config->killReward = tunables.killReward;
+	config->shootCooldown = tunables.shootCooldown;
+	config->speedOffsetIncr = tunables.enemySpeedOffsetIncr;
+	config->authoredWaves = NULL;
+	config->players = 1;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--stress") == 0)
+		{
+			config->formationCols = STRESS_FORMATION_COLS;
+			config->formationRows = STRESS_FORMATION_ROWS;
+			config->maxBullets = STRESS_MAX_PROJECTILES;
+			config->maxParticles = STRESS_MAX_PARTICLES;
+			config->enemyFireRate = STRESS_FIRE_RATE;
+			changed = true;
+		}
+	}
+
+	// Single values override the stress preset, wherever they are given
+	for (int i = 1; i < argc - 1; i++)
+	{
+		const char* value = argv[i + 1];
+
+		if (strcmp(argv[i], "--formation") == 0)
+		{
+			int cols, rows;
+			if (sscanf(value, "%dx%d", &cols, &rows) == 2 && cols > 0 && rows > 0)
+			{
+				config->formationCols = cols;
+				config->formationRows = rows;
+				changed = true;
+			}
+		}
+		else if (strcmp(argv[i], "--bullets") == 0)
+		{
+			config->maxBullets = max(1, atoi(value));
+			changed = true;
+		}
+		else if (strcmp(argv[i], "--particles") == 0)
+		{
+			config->maxParticles = max(1, atoi(value));
+			changed = true;
+		}
+		else if (strcmp(argv[i], "--fire-rate") == 0)
+		{
+			config->enemyFireRate = max(0.001f, (float)atof(value));
+			changed = true;
+		}
+		else if (strcmp(argv[i], "--kill-reward") == 0)
+		{
+			config->killReward = max(0, atoi(value));
+			changed = true;
+		}
+		else if (strcmp(argv[i], "--shoot-cooldown") == 0)
+		{
+			config->shootCooldown = max(0.0f, (float)atof(value));
+			changed = true;
+		}
+		else if (strcmp(argv[i], "--speed-incr") == 0)
+		{
+			config->speedOffsetIncr = (float)atof(value);
+			changed = true;
+		}
+		else if (strcmp(argv[i], "--waves") == 0 && loadWaveSchedule(&authoredWaves, value))
+		{
+			config->authoredWaves = &authoredWaves;
+			changed = true;
+		}
+	}
+
+	// Grow the field past the window when the formation needs it, keeping the room the default formation has to move and drop
+	float cellWidth = tunables.enemyWidth + FORMATION_GAP;
+	float cellHeight = tunables.enemyHeight + FORMATION_GAP;
+
+	config->fieldWidth = max(WINDOW_WIDTH, WINDOW_WIDTH + (config->formationCols - FORMATION_COLS) * cellWidth);
+	config->fieldHeight = max(WINDOW_HEIGHT, WINDOW_HEIGHT + (config->formationRows - FORMATION_ROWS) * cellHeight);
+
+	return changed;
+}
+
+#ifdef HOT_TUNABLES
+
+// Function that follows the reloaded tunables in the balance of a config. A value that differs from the tunable it started from was given
+// on the command line, and is kept
+void refreshGameConfig(GameConfig* config, const Tunables* previous)
+{
+	if (config->enemyFireRate == previous->enemyFireRate)
+		config->enemyFireRate = tunables.enemyFireRate;
+
+	if (config->killReward == previous->killReward)
+		config->killReward = tunables.killReward;
+
+	if (config->shootCooldown == previous->shootCooldown)
+		config->shootCooldown = tunables.shootCooldown;
+
+	if (config->speedOffsetIncr == previous->enemySpeedOffsetIncr)
+		config->speedOffsetIncr = tunables.enemySpeedOffsetIncr;
+}
+
+#endif
+
+// Function that allocates a world and creates the player and the first wave
+bool initGame(World* world, unsigned int seed, const GameConfig* config)
+{
+	// Allocate the world once, nothing is allocated while the game runs
+	if (!createWorld(world, config))
+		return false;
+
+	// Start from the first wave, so the game can be initialized again after quitGame
+	world->currentWave = 1;
+	world->enemyDir = 1;
+	world->gameOver = false;
+	world->playGame = false;
+	world->shootLatched = false;
+	world->partnerLatched = false;
+	world->sounds = 0;
+	world->gameFinished = false;
+	world->shotsFired = 0;
+	world->enemiesKilled = 0;
+	world->speedMult = tunables.enemySpeedMult;
+
+	// Every wave is worked out before the first one starts
+	createWaveSchedule(world);
+
+	// Set a seed for pseudo-random number generation, before the first wave draws its fire times
+	seedRandom(&world->gameRng, seed);
+	seedRandom(&world->particleRng, ~(Uint64)seed);
+
+	// Create player and enemies, the high score only lasts for as long as the world
+	world->player.hiScore = 0;
+	createPlayer(world);
+	createEnemies(world);
+
+	return true;
+}
+
+// Free the memory used by a world
+void quitGame(World* world)
+{
+	destroyWorld(world);
+}
+
+// Main update function that advances the simulation by one fixed tick
+void update(World* world, const PlayerInput* input, float delta) 
+{
+	if(world->playGame) 
+	{
+		// Remember where everything was for interpolation
+		world->player.lastPx = world->player.px;
+		world->player.lastPy = world->player.py;
+		world->partner.lastPx = world->partner.px;
+		world->partner.lastPy = world->partner.py;
+		world->formation.lastPx = world->formation.px;
+		world->formation.lastPy = world->formation.py;
+		saveEntityPositions(&world->bullets);
+
+		beginPhase(PHASE_PLAYER);
+		updatePlayer(world, input, delta);
+		endPhase(PHASE_PLAYER);
+
+		beginPhase(PHASE_BULLETS);
+		updateBullets(world, delta);
+		endPhase(PHASE_BULLETS);
+
+		beginPhase(PHASE_PARTICLES);
+		updateParticles(world);
+		endPhase(PHASE_PARTICLES);
+
+		beginPhase(PHASE_ENEMY_SHOOT);
+		enemyShoot(world, delta);
+		endPhase(PHASE_ENEMY_SHOOT);
+
+		beginPhase(PHASE_COLLISIONS);
+		checkBulletCollisions(world);
+		endPhase(PHASE_COLLISIONS);
+
+		beginPhase(PHASE_GAME_STATE);
+		checkGameState(world);
+		endPhase(PHASE_GAME_STATE);
+
+		beginPhase(PHASE_ENEMIES);
+		updateEnemies(world, delta);
+		endPhase(PHASE_ENEMIES);
+	}
+	else 
+	{
+		checkGameStart(world, input);
+	}
+}
+
+// Helper function that tells whether a world has a co-op partner
+static inline bool isCoop(const World* world)
+{
+	return world->config.players == 2;
+}
+
+// Helper function that puts a ship at its spawn point without interpolating across the screen. A single player starts in the middle,
+// co-op ships a third of the way in from either side
+static void spawnShip(const World* world, Player* ship)
+{
+	if (!isCoop(world))
+		ship->px = world->config.fieldWidth / 2;
+	else
+		ship->px = ship == &world->player ? world->config.fieldWidth / 3 : world->config.fieldWidth * 2 / 3;
+
+	ship->py = world->config.fieldHeight - (WINDOW_HEIGHT / 14);
+	ship->lastPx = ship->px;
+	ship->lastPy = ship->py;
+}
+
+// Function for creating the player, and the partner of co-op games
+void createPlayer(World* world)
+{
+	Player* player = &world->player;
+
+	// Initialize variables
+	spawnShip(world, player);
+	
+	player->score = 0;
+
+	player->livesLeft = 3;
+	player->shootTimer = 0.0;
+
+	world->partner = (Player){ .shootTimer = 0.0f };
+	if (isCoop(world))
+		spawnShip(world, &world->partner);
+}
+
+// Helper function that moves a ship and fires its shots
+static void updateShip(World* world, Player* player, bool* shootLatched, const PlayerInput* input, float delta)
+{
+	// Move right
+	if (input->right)
+	{
+		player->px += tunables.playerSpeed * delta;
+	}
+
+	// Move left
+	if (input->left)
+	{
+		player->px -= tunables.playerSpeed * delta;
+	}
+
+	// Shooting needs a fresh press after the one that started the game
+	if (*shootLatched && !input->shoot)
+		*shootLatched = false;
+
+	// Shoot
+	if (input->shoot && !*shootLatched)
+	{
+		if (player->shootTimer <= 0)
+		{
+			createBullet(world, (int)player->px, (int)player->py, -1);
+			requestSound(world, SOUND_SHOOT);
+			world->shotsFired++;
+
+			player->shootTimer = 1.0;
+		}
+	}
+
+	player->shootTimer -= delta * tunables.playerShootOffset;
+}
+
+// Function for updating the player, and the partner of co-op games with the second input
+void updatePlayer(World* world, const PlayerInput* input, float delta)
+{
+	updateShip(world, &world->player, &world->shootLatched, &input[0], delta);
+
+	if (isCoop(world))
+		updateShip(world, &world->partner, &world->partnerLatched, &input[1], delta);
+}
+
+// Function that works out every wave of a game, from the authored schedule of the config or the balance of the original game
+void createWaveSchedule(World* world)
+{
+	if (world->config.authoredWaves)
+		world->schedule = *world->config.authoredWaves;
+	else
+		buildDefaultWaves(&world->schedule, world->config.killReward, world->config.enemyFireRate, tunables.baseEnemySpeedOffset);
+}
+
+// Function for creating a new set of enemies
+void createEnemies(World* world)
+{
+	// Everything about the wave was worked out before the game, the store and the formation are refilled in place
+	world->waveParams = getWaveParams(&world->schedule, world->currentWave);
+	const WaveParams* wave = &world->waveParams;
+
+	resetFormation(&world->formation, FORMATION_START_X, FORMATION_START_Y);
+
+	for(int i = 0; i < world->enemies.capacity; i++) 
+	{
+		// Get row and column
+		int px = i % world->formation.cols;
+		int py = i / world->formation.cols;
+
+		// Cells the layout leaves out stay dead for the whole wave
+		if (!isLayoutCell(wave->layout, px, py, world->formation.cols, world->formation.rows))
+		{
+			killFormationCell(&world->formation, px, py);
+			continue;
+		}
+
+		// Enemies keep the slot of their place in the formation
+		spawnEntityAt(&world->enemies, i);
+
+		// Offset from the formation origin
+		world->enemies.px[i] = (float)px * tunables.enemyWidth + (FORMATION_GAP * (float)px);
+		world->enemies.py[i] = (float)py * tunables.enemyHeight + (FORMATION_GAP * (float)py);
+		world->enemies.tag[i] = wave->reward;
+		world->enemies.timer[i] = wave->firstShot;
+	}
+
+	// The bottom row shoots first, each with its own random wait on top of the initial cooldown
+	for (int col = 0; col < world->formation.cols; col++)
+	{
+		if (world->formation.bottomRow[col] >= 0)
+			world->enemies.timer[world->formation.bottomRow[col] * world->formation.cols + col] += nextRandomWait(&world->gameRng, wave->fireRate);
+	}
+
+	world->speedOffset = wave->speedOffset;
+
+	// The offsets never change during a wave, so the broad phase is only built here
+	buildCollisionGrid(&world->enemyGrid, &world->enemies);
+}
+
+// Function for killing an enemy and removing it from its column and row
+void killEnemy(World* world, int slot)
+{
+	int col = slot % world->formation.cols;
+
+	killEntity(&world->enemies, slot);
+
+	// If the bottom enemy of the column was killed, the one above it becomes the shooter of the column
+	if (killFormationCell(&world->formation, col, slot / world->formation.cols) && world->formation.bottomRow[col] >= 0)
+		world->enemies.timer[world->formation.bottomRow[col] * world->formation.cols + col] += nextRandomWait(&world->gameRng, world->waveParams.fireRate);
+}
+
+// Function for updating enemies
+void updateEnemies(World* world, float delta)
+{
+	int left = getLeftmostColumn(&world->formation);
+	int right = getRightmostColumn(&world->formation);
+
+	if (left < 0)
+		return;
+
+	// Move the whole formation, right if 1, else left
+	world->formation.px += ((float)tunables.enemySpeed + world->speedOffset) * world->speedMult * delta * (float)world->enemyDir;
+
+	// Only the outermost live columns can touch an edge
+	float cellWidth = tunables.enemyWidth + FORMATION_GAP;
+	float leftX = world->formation.px + (float)left * cellWidth;
+	float rightX = world->formation.px + (float)right * cellWidth;
+
+	// If the formation is too close to the edge it is moving towards, change its direction and move it down by 1/4 of the enemy height
+	if ((world->enemyDir == -1 && leftX < tunables.enemyWidth) || (world->enemyDir == 1 && rightX > world->config.fieldWidth - tunables.enemyWidth))
+	{
+		world->enemyDir = -world->enemyDir;
+		world->formation.py += tunables.enemyHeight / 4;
+	}
+
+	// If the lowest row gets too close to player, end the game
+	float bottomY = world->formation.py + (float)getBottomRow(&world->formation) * (tunables.enemyHeight + FORMATION_GAP);
+	if (bottomY > world->config.fieldHeight - tunables.playerHeight * 2 - tunables.enemyHeight)
+		world->gameOver = true;
+}
+
+// Function that makes the bottom enemy of every column shoot on a semi-random basis.
+// The timer of a shooter holds the time until its next shot, drawn once whenever it shoots.
+void enemyShoot(World* world, float delta)
+{
+	for (int col = 0; col < world->formation.cols; col++)
+	{
+		int row = world->formation.bottomRow[col];
+		if (row < 0)
+			continue;
+
+		int index = row * world->formation.cols + col;
+
+		world->enemies.timer[index] -= delta;
+
+		if (world->enemies.timer[index] <= 0)
+		{
+			createBullet(world, (int)getEnemyX(world, index), (int)getEnemyY(world, index), 1);
+
+			requestSound(world, SOUND_SHOOT);
+
+			world->enemies.timer[index] = world->config.shootCooldown + nextRandomWait(&world->gameRng, world->waveParams.fireRate);
+		}
+	}
+}
+
+// Function for creating a new bullet
+void createBullet(World* world, int px, int py, int dir)
+{
+	int w_offset = 0, h_offset = 0;
+
+	if (dir == -1) {
+		w_offset = tunables.playerWidth / 2;
+		h_offset = tunables.playerHeight / 2;
+	}
+	else if (dir == 1) {
+		w_offset = tunables.enemyWidth / 2;
+		h_offset = tunables.enemyHeight / 2;
+	}
+
+	// Take a free slot, the bullet is dropped if every slot is in use
+	int i = spawnEntity(&world->bullets);
+
+	if (i >= 0)
+	{
+		world->bullets.px[i] = (float)px + w_offset;
+		world->bullets.py[i] = (float)py + h_offset;
+		world->bullets.lastPx[i] = world->bullets.px[i];
+		world->bullets.lastPy[i] = world->bullets.py[i];
+		world->bullets.tag[i] = dir;
+	}
+}
+
+// Function for updating all bullets
+void updateBullets(World* world, float delta)
+{
+	// Every slot is moved and tested several at a time, the dead ones too. That is cheaper than following the live list,
+	// and dead slots are overwritten when they are spawned again
+	moveTagged(world->bullets.py, world->bullets.tag, (float)tunables.bulletSpeed, delta, world->bullets.capacity);
+	findOutside(world->bullets.py, world->bullets.capacity, 0.0f, world->config.fieldHeight - tunables.bulletHeight, world->bulletsOutside);
+
+	// Loop backwards, killing a bullet moves the last live bullet into its place in the list
+	for (int n = world->bullets.count - 1; n >= 0; n--)
+	{
+		int i = world->bullets.live[n];
+
+		if (world->bulletsOutside[i >> 5] & (1u << (i & 31)))
+		{
+			createExplosion(world, world->bullets.px[i], world->bullets.py[i], BULLET_EXPLOSION);
+
+			killEntity(&world->bullets, i);
+			
+			requestSound(world, SOUND_HIT);
+		}
+	}
+}
+
+// Function for creating an explosion with its top-left corner at the given coordinates
+void createExplosion(World* world, float px, float py, ParticleTypes type)
+{
+	const ExplosionStyle* style = &explosionStyles[type];
+
+	// The flash stays where the explosion happened
+	emitParticle(&world->particles, px, py, 0.0f, 0.0f, tunables.particleWidth, (Uint8)type);
+
+	// Debris flies out from the middle in random directions
+	float offset = (tunables.particleWidth - style->debrisSize) / 2;
+
+	for (int n = 0; n < style->debris; n++)
+	{
+		float angle = nextRandomFloat(&world->particleRng) * 2.0f * (float)M_PI;
+		float speed = style->minSpeed + nextRandomFloat(&world->particleRng) * (style->maxSpeed - style->minSpeed);
+
+		emitParticle(&world->particles, px + offset, py + offset, SDL_cosf(angle) * speed, SDL_sinf(angle) * speed, style->debrisSize, (Uint8)type);
+	}
+}
+
+// Function for updating particles. Their positions follow from their age, so only the expired ones are touched
+void updateParticles(World* world)
+{
+	advanceParticles(&world->particles);
+}
+
+// Function that finds the first enemy touching a bullet. Only enemies in the grid cells around the bullet are tested,
+// the cells of a row hold their items next to each other so a whole row is tested at once
+static int findEnemyHit(const World* world, const SDL_Rect* bulletRect)
+{
+	// The grid is in formation space, so move the bullet into it
+	float bx = (float)bulletRect->x - world->formation.px;
+	float by = (float)bulletRect->y - world->formation.py;
+
+	// An enemy can only touch the bullet if its top-left corner is within one enemy size of the bullet
+	int cx0, cy0, cx1, cy1;
+	getGridCellRange(&world->enemyGrid,
+		bx - tunables.enemyWidth - 1, by - tunables.enemyHeight - 1,
+		bx + (float)bulletRect->w + 1, by + (float)bulletRect->h + 1,
+		&cx0, &cy0, &cx1, &cy1);
+
+	const CollisionGrid* grid = &world->enemyGrid;
+
+	for (int cy = cy0; cy <= cy1; cy++)
+	{
+		int first, last, unused;
+		getGridCell(grid, cx0, cy, &first, &unused);
+		getGridCell(grid, cx1, cy, &unused, &last);
+
+		// Enemies are placed at whole pixels below their position, like the rectangle of the bullet
+		for (int k = first; (k = findOverlap(grid->itemPx, grid->itemPy, k, last, world->formation.px, world->formation.py,
+			(int)tunables.enemyWidth, (int)tunables.enemyHeight, bulletRect)) >= 0; k++)
+		{
+			int j = grid->items[k];
+
+			// The grid isn't updated when an enemy dies during this tick
+			if (isEntityAlive(&world->enemies, j))
+				return j;
+		}
+	}
+
+	return -1;
+}
+
+// Function for cheking bullet collisions
+void checkBulletCollisions(World* world)
+{
+	Player* player = &world->player;
+
+	Player* ships[MAX_PLAYERS] = { &world->player, &world->partner };
+	int shipCount = isCoop(world) ? 2 : 1;
+
+	SDL_Rect shipRects[MAX_PLAYERS];
+	for (int s = 0; s < shipCount; s++)
+	{
+		shipRects[s] = (SDL_Rect){
+			.x = (int)ships[s]->px,
+			.y = (int)ships[s]->py,
+			.w = tunables.playerWidth,
+			.h = tunables.playerHeight
+		};
+	}
+
+	for (int n = world->bullets.count - 1; n >= 0; n--)
+	{
+		int i = world->bullets.live[n];
+
+		SDL_Rect bulletRect = {
+			.x = (int)world->bullets.px[i],
+			.y = (int)world->bullets.py[i],
+			.w = tunables.bulletWidth,
+			.h = tunables.bulletHeight
+		};
+
+		// Player bullets can hit enemies
+		if (world->bullets.tag[i] != 1)
+		{
+			int hit = findEnemyHit(world, &bulletRect);
+
+			if (hit >= 0)
+			{
+				LOG_MESSAGE("Enemy hit: slot %d", hit);
+				requestSound(world, SOUND_HIT);
+
+				player->score += world->enemies.tag[hit];
+
+				createExplosion(world, (float)(int)getEnemyX(world, hit), (float)(int)getEnemyY(world, hit), SHIP_EXPLOSION);
+
+				world->speedOffset += world->config.speedOffsetIncr;
+
+				killEnemy(world, hit);
+				killEntity(&world->bullets, i);
+				world->enemiesKilled++;
+
+				continue;
+			}
+		}
+
+		// Enemy bullets can hit either ship, the lives are shared
+		for (int s = 0; s < shipCount && world->bullets.tag[i] != -1; s++)
+		{
+			if (SDL_HasIntersection(&bulletRect, &shipRects[s]))
+			{
+				createExplosion(world, world->bullets.px[i], world->bullets.py[i], SHIP_EXPLOSION);
+
+				killEntity(&world->bullets, i);
+
+				requestSound(world, SOUND_HIT);
+
+				player->livesLeft -= 1;
+
+				if (player->livesLeft <= 0)
+					world->gameOver = true;
+
+				// Respawn without interpolating across the screen
+				spawnShip(world, ships[s]);
+				break;
+			}
+		}
+	}
+}
+
+// Function for ending the game and spawning new waves
+void checkGameState(World* world)
+{
+	Player* player = &world->player;
+
+	// If game is over, hand the result to the high scores, set a new highscore, create a new player and create new enemies
+	if (world->gameOver)
+	{
+		world->lastGame = (GameResult){ .score = player->score, .wave = world->currentWave };
+		world->gameFinished = true;
+
+		player->hiScore = max(player->hiScore, player->score);
+		createPlayer(world);
+
+		freeEnemies(world);
+		freeBullets(world);
+
+		createEnemies(world);
+
+		world->gameOver = false;
+	}
+	
+	// If no more enemies exist, spawn a new wave. The store keeps the count of live enemies, and the wave refills it in place. Reset player lives to three.
+	if (world->enemies.count == 0)
+	{
+		world->currentWave += 1;
+
+		freeEnemies(world);
+		createEnemies(world);
+
+		player->livesLeft = 3;
+	}
+}
+
+// Kill every enemy
+void freeEnemies(World* world) 
+{
+	resetEntityStore(&world->enemies);
+}
+
+// Kill every bullet
+void freeBullets(World* world) 
+{
+	resetEntityStore(&world->bullets);
+}
+	
+// Kill every particle
+void freeParticles(World* world) 
+{
+	clearParticles(&world->particles);
+}
+
+// Start the game from the menu once shoot is pressed. The press stays latched so it doesn't also fire the first shot
+void checkGameStart(World* world, const PlayerInput* input) 
+{
+	bool partnerShoot = isCoop(world) && input[1].shoot;
+
+	// Either ship starts a co-op game, only the ships that pressed shoot are latched
+	if(input[0].shoot || partnerShoot) 
+	{
+		world->playGame = true;
+		world->shootLatched = input[0].shoot;
+		world->partnerLatched = partnerShoot;
+	}
+}
+
+// Function that plays every sound requested since the last call
+void playWorldSounds(World* world)
+{
+	for (int i = 0; i < SOUND_COUNT; i++)
+		if (world->sounds & (1u << i))
+			playSound((Sound)i);
+
+	world->sounds = 0;
+}
+
+// Function that hashes everything the simulation depends on
+Uint32 hashGameState(const World* world)
+{
+	Uint32 hash = FNV_OFFSET_BASIS;
+
+	hash = hashBytes(hash, &world->player, sizeof world->player);
+	hash = hashBytes(hash, &world->gameRng, sizeof world->gameRng);
+	hash = hashBytes(hash, &world->particleRng, sizeof world->particleRng);
+	hash = hashBytes(hash, &world->formation.px, sizeof world->formation.px);
+	hash = hashBytes(hash, &world->formation.py, sizeof world->formation.py);
+	hash = hashBytes(hash, &world->enemyDir, sizeof world->enemyDir);
+	hash = hashBytes(hash, &world->currentWave, sizeof world->currentWave);
+	hash = hashBytes(hash, &world->speedOffset, sizeof world->speedOffset);
+	hash = hashBytes(hash, &world->playGame, sizeof world->playGame);
+	hash = hashBytes(hash, &world->shootLatched, sizeof world->shootLatched);
+
+	// Single player games hash the same as before there was a partner
+	if (isCoop(world))
+	{
+		hash = hashBytes(hash, &world->partner, sizeof world->partner);
+		hash = hashBytes(hash, &world->partnerLatched, sizeof world->partnerLatched);
+	}
+
+	// Particles are only for show and follow from the particle generator, so where the ring buffer is covers them
+	hash = hashBytes(hash, &world->particles.tick, sizeof world->particles.tick);
+	hash = hashBytes(hash, &world->particles.head, sizeof world->particles.head);
+	hash = hashBytes(hash, &world->particles.count, sizeof world->particles.count);
+
+	// Only live entities matter, dead slots keep stale values
+	const EntityStore* stores[] = { &world->enemies, &world->bullets };
+	for (int s = 0; s < 2; s++)
+	{
+		const EntityStore* store = stores[s];
+		hash = hashBytes(hash, &store->count, sizeof store->count);
+
+		for (int n = 0; n < store->count; n++)
+		{
+			int i = store->live[n];
+
+			hash = hashBytes(hash, &i, sizeof i);
+			hash = hashBytes(hash, &store->px[i], sizeof store->px[i]);
+			hash = hashBytes(hash, &store->py[i], sizeof store->py[i]);
+			hash = hashBytes(hash, &store->timer[i], sizeof store->timer[i]);
+			hash = hashBytes(hash, &store->tag[i], sizeof store->tag[i]);
+		}
+	}
+
+	return hash;
+}
@@ -0,0 +1,262 @@
+#pragma once
+
+// SDL libraries
+#include <SDL.h>
+
+// Game modules
+#include "collision.h"
+#include "entities.h"
+#include "formation.h"
+#include "particles.h"
+#include "rng.h"
+#include "tunables.h"
+#include "waves.h"
+
+// Helper libraries
+#include <stdbool.h>
+
+#pragma region Structs and ENUMs
+
+typedef struct Player
+{
+	float px, py; // Coordinates
+	float lastPx, lastPy; // Coordinates at the start of the current tick, used for interpolation
+
+	int score; // Current score
+	int hiScore; // High-score
+
+	int livesLeft; // Amount of lives left until game resets
+	float shootTimer; // Cooldown for shooting bullets
+} Player;
+
+typedef enum ParticleTypes {BULLET_EXPLOSION, SHIP_EXPLOSION} ParticleTypes; // Types of particles, every explosion is made of several of them
+
+// Input for a single tick, filled from the keyboard or from a scripted controller
+typedef struct PlayerInput
+{
+	bool left, right; // Movement
+	bool shoot; // Shoot, also starts the game from the menu
+} PlayerInput;
+
+// How a game ended, handed from the simulation to the high scores
+typedef struct GameResult
+{
+	int score;
+	int wave; // Wave the game ended on
+} GameResult;
+
+// Size of the game, fixed when the game is initialized. The defaults are the original game, stress runs raise them
+typedef struct GameConfig
+{
+	int formationCols, formationRows; // Size of the enemy formation
+	int maxBullets, maxParticles; // Capacity of the bullet store and the particle emitter
+
+	float enemyFireRate; // Average shots per second of every column once its cooldown is over
+
+	// Balance of the game, the defaults are the constants below
+	int killReward; // Score for killing an enemy on the first wave, multiplied by the wave number
+	float shootCooldown; // Wait of an enemy after it shoots, on top of its random wait
+	float speedOffsetIncr; // Added to the enemy speed for every kill
+
+	// Waves from "--waves FILE", NULL for the progression of the original game built from the balance above
+	const WaveSchedule* authoredWaves;
+
+	float fieldWidth, fieldHeight; // Play field, the window size unless the formation needs more room
+
+	int players; // Ships in the game, 2 for co-op. Anything else is a single player
+} GameConfig;
+
+// Everything the simulation changes. The arrays of the stores, the formation, the grid and the bullet mask live in one block owned by the world,
+// so a world is copied with two memcpy calls, one for the struct and one for the block
+typedef struct World
+{
+	GameConfig config; // Size of the world, fixed when it's created
+
+	Player player;
+
+	// Second ship of co-op games. The score and the lives of the first player are shared, the partner only moves and shoots.
+	// It has a latch of its own for the press that started the game
+	Player partner;
+	bool partnerLatched;
+
+	// Enemies store their offset from the formation origin as coordinates, and use the tag for their kill reward and the timer as a shooting cooldown,
+	// bullets use the tag for their Y-velocity
+	EntityStore enemies;
+	EntityStore bullets;
+
+	// Particles of every explosion
+	ParticleEmitter particles;
+
+	// Enemy formation, moved as a single origin
+	Formation formation;
+
+	// Broad phase for bullet-vs-enemy collisions. Built in formation space, so it only changes when a new wave spawns
+	CollisionGrid enemyGrid;
+
+	// Scratch bitmask of the bullets that left the field this tick, a bit per slot
+	Uint32* bulletsOutside;
+
+	// Random number generator of the game, and a separate one for particles so explosions never change how the game plays out
+	Rng gameRng;
+	Rng particleRng;
+
+	// Current enemy direction and wave number
+	int enemyDir;
+	int currentWave;
+
+	// Every wave of the game, built when the world is initialized, and the parameters of the current one
+	WaveSchedule schedule;
+	WaveParams waveParams;
+
+	// Added to the enemy speed for every kill, and the multiplier of the whole speed
+	float speedOffset;
+	float speedMult;
+
+	// Booleans for determining if the game is over and if the game is being played instead of showing the menu
+	bool gameOver;
+	bool playGame;
+
+	// Set when shoot starts the game, and cleared once shoot is let go. Holding shoot from the menu doesn't fire
+	bool shootLatched;
+
+	// Sounds requested since they were last played, a bit per Sound. The simulation never calls into audio itself
+	Uint32 sounds;
+
+	// Result of the last game that ended, kept until it has been recorded. The simulation never writes files itself
+	GameResult lastGame;
+	bool gameFinished;
+
+	// Player shots and enemy kills since the telemetry last took them, not part of the game state
+	Uint32 shotsFired;
+	Uint32 enemiesKilled;
+
+	void* memory; // Block holding every array of the world
+	size_t memorySize;
+} World;
+
+// Copy of a world. Only restores into a world created with the same config
+typedef struct WorldSnapshot
+{
+	World world; // The world as it was saved, its pointers still refer to the world it was taken from
+	void* memory; // Copy of the block of the world
+} WorldSnapshot;
+
+#pragma endregion
+
+#pragma region Globals and defines
+
+// Window size
+#define WINDOW_WIDTH 640
+#define WINDOW_HEIGHT 480
+
+// Fixed simulation rate. Rendering interpolates between the last two ticks
+#define TICK_RATE 120
+#define TICK_TIME (1.0 / TICK_RATE)
+
+// Default size of the enemy formation, the gap between enemies and where it starts
+#define FORMATION_COLS 11
+#define FORMATION_ROWS 5
+#define FORMATION_GAP 10.0f
+#define FORMATION_START_X 100.0f
+#define FORMATION_START_Y 100.0f
+
+// Most ships in a game, the player and the co-op partner
+#define MAX_PLAYERS 2
+
+// Default maximums for projectiles (bullets) and particles
+#define MAX_PROJECTILES 20
+#define MAX_PARTICLES 512
+
+// Size of the stress test, used with "--stress"
+#define STRESS_FORMATION_COLS 100
+#define STRESS_FORMATION_ROWS 40
+#define STRESS_MAX_PROJECTILES 4096
+#define STRESS_MAX_PARTICLES 16384
+#define STRESS_FIRE_RATE 2.0f
+
+// The world that is played and rendered
+extern World gameWorld;
+
+#pragma endregion
+
+#pragma region Function declarations
+
+// Configuration from the command line: "--stress", "--formation COLSxROWS", "--bullets N", "--particles N", "--fire-rate F",
+// the balance with "--kill-reward N", "--shoot-cooldown F", "--speed-incr F", and "--waves FILE". Returns true if anything was changed from the defaults
+bool parseGameConfig(int argc, char* argv[], GameConfig* config);
+
+#ifdef HOT_TUNABLES
+// Take the balance tunables that changed into a config, unless the command line set them
+void refreshGameConfig(GameConfig* config, const Tunables* previous);
+#endif
+
+// Initialization and exit. A world is allocated once and starts from the menu with its first wave
+bool initGame(World* world, unsigned int seed, const GameConfig* config);
+void quitGame(World* world);
+
+// Allocate the block of a world and point every array into it
+bool createWorld(World* world, const GameConfig* config);
+void destroyWorld(World* world);
+
+// Snapshots. Saving and restoring are each a copy of the world struct and of its block, no allocation
+bool createSnapshot(WorldSnapshot* snapshot, const World* world);
+void freeSnapshot(WorldSnapshot* snapshot);
+void saveSnapshot(WorldSnapshot* snapshot, const World* world);
+bool restoreSnapshot(World* world, const WorldSnapshot* snapshot);
+
+// Main update method, the input has an entry for every ship of the config
+void update(World* world, const PlayerInput* input, float delta);
+
+// Player methods
+void createPlayer(World* world);
+void updatePlayer(World* world, const PlayerInput* input, float delta);
+
+// Enemy methods
+void createWaveSchedule(World* world);
+void createEnemies(World* world);
+void killEnemy(World* world, int slot);
+void updateEnemies(World* world, float delta);
+void enemyShoot(World* world, float delta);
+
+// Bullet methods
+void createBullet(World* world, int px, int py, int dir);
+void updateBullets(World* world, float delta);
+
+// Particle methods
+void createExplosion(World* world, float px, float py, ParticleTypes type);
+void updateParticles(World* world);
+
+// Collision checking and game state checking
+void checkBulletCollisions(World* world);
+void checkGameState(World* world);
+
+// Killing every entity of a kind
+void freeEnemies(World* world);
+void freeBullets(World* world);
+void freeParticles(World* world);
+
+// Menu functions
+void checkGameStart(World* world, const PlayerInput* input);
+
+// Hand the sounds requested by the simulation to the audio module, from the thread that owns the audio
+void playWorldSounds(World* world);
+
+// Hash of the whole simulation state, used for checking that a replay plays out like the recording
+Uint32 hashGameState(const World* world);
+
+#pragma endregion
+
+#pragma region Inline helpers
+
+// Enemies store their offset from the formation origin, these give their position on screen
+static inline float getEnemyX(const World* world, int slot)
+{
+	return world->formation.px + world->enemies.px[slot];
+}
+
+static inline float getEnemyY(const World* world, int slot)
+{
+	return world->formation.py + world->enemies.py[slot];
+}
+
+#pragma endregion
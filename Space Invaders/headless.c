@@ -0,0 +1,269 @@
+#include "headless.h"
+
+// Game modules
+#include "game.h"
+#include "kernels.h"
+#include "logging.h"
+#include "rng.h"
+
+// Standard libraries
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+// Default amount of ticks, one minute of game time
+#define DEFAULT_HEADLESS_TICKS (60 * TICK_RATE)
+
+// Controller that presses random buttons, changing its mind every few ticks
+static void randomPolicy(PolicyState* state, PlayerInput* input, Uint64 tick)
+{
+	if (tick % 8 == 0)
+	{
+		Uint32 r = nextRandom(&state->rng);
+		state->held.left = (r & 3) == 1;
+		state->held.right = (r & 3) == 2;
+		state->held.shoot = (r & 4) != 0;
+	}
+
+	*input = state->held;
+}
+
+// Controller that moves under the closest enemy, shoots when lined up and steps away from enemy bullets
+static void trackerPolicy(const World* world, PlayerInput* input)
+{
+	float center = world->player.px + tunables.playerWidth / 2;
+
+	// Find the enemy that is closest horizontally
+	float target = center;
+	float bestDistance = world->config.fieldWidth;
+
+	// Every enemy of a column has the same x, so only columns that still have one are checked
+	for (int col = 0; col < world->formation.cols; col++)
+	{
+		if (world->formation.bottomRow[col] < 0)
+			continue;
+
+		float enemyCenter = world->formation.px + (float)col * (tunables.enemyWidth + FORMATION_GAP) + tunables.enemyWidth / 2;
+		float distance = SDL_fabsf(enemyCenter - center);
+
+		if (distance < bestDistance)
+		{
+			bestDistance = distance;
+			target = enemyCenter;
+		}
+	}
+
+	// Dodge an enemy bullet that is about to land on the player
+	for (int n = 0; n < world->bullets.count; n++)
+	{
+		int i = world->bullets.live[n];
+
+		if (world->bullets.tag[i] == 1 && world->bullets.py[i] > world->player.py - 80 &&
+			SDL_fabsf(world->bullets.px[i] + tunables.bulletWidth / 2 - center) < tunables.playerWidth)
+		{
+			target = world->bullets.px[i] < center ? center + tunables.playerWidth * 2 : center - tunables.playerWidth * 2;
+			break;
+		}
+	}
+
+	input->left = target < center - 2;
+	input->right = target > center + 2;
+	input->shoot = bestDistance < tunables.enemyWidth / 2;
+}
+
+// Function that starts a controller from a seed
+void initPolicy(PolicyState* state, unsigned int seed)
+{
+	seedRandom(&state->rng, seed);
+	state->held = (PlayerInput){ false };
+}
+
+// Function for getting the input of a scripted controller for the next tick
+void getPolicyInput(HeadlessPolicy policy, PolicyState* state, const World* world, Uint64 tick, PlayerInput* input)
+{
+	*input = (PlayerInput){ false };
+
+	// Start the game from the menu like a player would, so recordings of headless runs replay the same way
+	if (!world->playGame)
+		input->shoot = true;
+	else if (policy == POLICY_RANDOM)
+		randomPolicy(state, input, tick);
+	else if (policy == POLICY_TRACKER)
+		trackerPolicy(world, input);
+}
+
+// Function that parses "--headless", "--ticks N", "--seed N", "--policy idle|random|tracker", "--agent LIB", "--agent-batch N" and the replay options
+bool parseHeadlessOptions(int argc, char* argv[], HeadlessOptions* options)
+{
+#ifdef HEADLESS
+	bool headless = true;
+#else
+	bool headless = false;
+#endif
+
+	options->ticks = DEFAULT_HEADLESS_TICKS;
+	options->seed = 1;
+	options->policy = POLICY_TRACKER;
+	options->agentPath = NULL;
+	options->agentBatch = DEFAULT_AGENT_BATCH;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--headless") == 0)
+			headless = true;
+		else if (strcmp(argv[i], "--ticks") == 0 && i + 1 < argc)
+			options->ticks = strtoull(argv[++i], NULL, 10);
+		else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+			options->seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+		else if (strcmp(argv[i], "--policy") == 0 && i + 1 < argc)
+		{
+			const char* policy = argv[++i];
+
+			if (strcmp(policy, "idle") == 0)
+				options->policy = POLICY_IDLE;
+			else if (strcmp(policy, "random") == 0)
+				options->policy = POLICY_RANDOM;
+			else
+				options->policy = POLICY_TRACKER;
+		}
+		else if (strcmp(argv[i], "--agent") == 0 && i + 1 < argc)
+			options->agentPath = argv[++i];
+		else if (strcmp(argv[i], "--agent-batch") == 0 && i + 1 < argc)
+		{
+			int batch = atoi(argv[++i]);
+			options->agentBatch = max(batch, 1);
+		}
+	}
+
+	// A replay brings its own seed and input, and runs for as long as the recording
+	parseReplayOptions(argc, argv, &options->replay);
+	if (options->replay.replayPath)
+		options->policy = POLICY_REPLAY;
+	else if (options->agentPath)
+		options->policy = POLICY_AGENT;
+
+	parseProfilerOptions(argc, argv, &options->profiler);
+	parseGameConfig(argc, argv, &options->game);
+
+	return headless;
+}
+
+// Function that runs the simulation without a window, renderer, audio or fonts
+int runHeadless(const HeadlessOptions* options)
+{
+	InputReplay replay = { NULL };
+	InputRecorder recorder = { NULL };
+
+	World world;
+	PolicyState policy;
+	AgentLibrary agents = { NULL };
+	AgentGroup agent = { NULL };
+	unsigned int seed = options->seed;
+	GameConfig config = options->game;
+
+	if (options->policy == POLICY_REPLAY)
+	{
+		if (!loadReplay(&replay, options->replay.replayPath, &config))
+			return 1;
+
+		seed = replay.seed;
+	}
+
+	if (!initGame(&world, seed, &config))
+	{
+		quitGame(&world);
+		freeReplay(&replay);
+		return 1;
+	}
+
+	initPolicy(&policy, seed);
+
+	if (options->policy == POLICY_AGENT && (!loadAgentLibrary(&agents, options->agentPath) || !createAgentGroup(&agent, &agents, 1)))
+	{
+		unloadAgentLibrary(&agents);
+		quitGame(&world);
+		return 1;
+	}
+
+	enableLogging(options->profiler.logging);
+	setProfiling(options->profiler.outputPath != NULL);
+
+	// A run asked to record is of no use without the recording, startRecording says why it couldn't open the file
+	if (options->replay.recordPath && !startRecording(&recorder, options->replay.recordPath, seed, &config))
+	{
+		if (options->policy == POLICY_AGENT)
+		{
+			destroyAgentGroup(&agent);
+			unloadAgentLibrary(&agents);
+		}
+
+		quitGame(&world);
+		freeReplay(&replay);
+		return 1;
+	}
+
+	Uint64 frequency = SDL_GetPerformanceFrequency();
+	Uint64 start = SDL_GetPerformanceCounter();
+
+	Uint64 ticks = 0;
+	while (options->policy == POLICY_REPLAY || ticks < options->ticks)
+	{
+		PlayerInput input = { false };
+
+		beginPhase(PHASE_INPUT);
+
+		if (options->policy == POLICY_REPLAY)
+		{
+			// The run ends with the recording
+			if (!nextReplayInput(&replay, &input))
+				break;
+		}
+		else if (options->policy == POLICY_AGENT)
+		{
+			stepAgentGroup(&agent, &world, &seed, 1, ticks, &input);
+		}
+		else
+		{
+			getPolicyInput(options->policy, &policy, &world, ticks, &input);
+		}
+
+		recordInput(&recorder, &input);
+		endPhase(PHASE_INPUT);
+
+		update(&world, &input, (float)TICK_TIME);
+
+		ticks++;
+	}
+
+	double seconds = (double)(SDL_GetPerformanceCounter() - start) / (double)frequency;
+
+	printf("Headless run: %llu ticks in %.3f s, %.0f ticks/s, %.3f us/tick\n",
+		(unsigned long long)ticks, seconds, seconds > 0 ? (double)ticks / seconds : 0.0, ticks > 0 ? seconds * 1000000.0 / (double)ticks : 0.0);
+	printf("Size: %d enemies, %d bullets, %d particles, %s kernels\n", world.enemies.capacity, world.bullets.capacity, world.particles.capacity,
+		getKernelLevelName(getKernelLevel()));
+	printf("Score: %d, High score: %d, Wave: %d, Lives: %d\n", world.player.score, world.player.hiScore, world.currentWave, world.player.livesLeft);
+
+	Uint32 stateHash = hashGameState(&world);
+	stopRecording(&recorder, stateHash);
+
+	int result = 0;
+	if (options->policy == POLICY_REPLAY)
+	{
+		result = checkReplayResult(&replay, stateHash) ? 0 : 2;
+		freeReplay(&replay);
+	}
+
+	if (options->profiler.outputPath)
+		writeProfile(options->profiler.outputPath);
+	flushLog();
+
+	if (options->policy == POLICY_AGENT)
+	{
+		destroyAgentGroup(&agent);
+		unloadAgentLibrary(&agents);
+	}
+
+	quitGame(&world);
+
+	return result;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+// SDL libraries
+#include <SDL.h>
+
+// Game modules
+#include "agenthost.h"
+#include "game.h"
+#include "profiler.h"
+#include "replay.h"
+#include "rng.h"
+
+// Helper libraries
+#include <stdbool.h>
+
+#pragma region Structs and ENUMs
+
+// Scripted controllers that can drive the player without a keyboard, or a policy from a shared library
+typedef enum HeadlessPolicy { POLICY_IDLE, POLICY_RANDOM, POLICY_TRACKER, POLICY_REPLAY, POLICY_AGENT } HeadlessPolicy;
+
+typedef struct HeadlessOptions
+{
+	Uint64 ticks; // Amount of fixed ticks to simulate
+	unsigned int seed; // Seed for the game and the random controller
+	HeadlessPolicy policy; // Controller that drives the player
+
+	const char* agentPath; // Library of the agent policy, from "--agent LIB"
+	int agentBatch; // Games a batch worker steps the agent with at once
+
+	ReplayOptions replay; // Recording of the run, or a recording to replay instead of a controller
+	ProfilerOptions profiler; // Phases are only timed when a profile is written
+	GameConfig game; // Formation size and entity caps
+} HeadlessOptions;
+
+// State of a scripted controller. Every simulated game has its own, so games can run side by side
+typedef struct PolicyState
+{
+	Rng rng; // Generator of the random controller, kept apart from the game's generator
+	PlayerInput held; // Buttons the random controller is holding
+} PolicyState;
+
+#pragma endregion
+
+#pragma region Function declarations
+
+// Parse headless options from the command line. Returns false if headless mode wasn't requested
+bool parseHeadlessOptions(int argc, char* argv[], HeadlessOptions* options);
+
+// Run the game logic as fast as possible without a window, audio or fonts and print the tick rate
+int runHeadless(const HeadlessOptions* options);
+
+// Scripted controllers. The input of a tick only depends on the state of the controller and of the world
+void initPolicy(PolicyState* state, unsigned int seed);
+void getPolicyInput(HeadlessPolicy policy, PolicyState* state, const World* world, Uint64 tick, PlayerInput* input);
+
+#pragma endregion
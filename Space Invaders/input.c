@@ -0,0 +1,285 @@
+#include "input.h"
+
+// Standard libraries
+#include <string.h>
+
+#pragma region Structs and ENUMs
+
+// Actions the player can take, used as bit indices
+typedef enum InputAction { ACTION_LEFT, ACTION_RIGHT, ACTION_SHOOT } InputAction;
+
+// Where an action comes from: the keyboard, then the buttons and the stick of every gamepad.
+// Each source keeps its own state, so letting go of a key doesn't cancel a button that is still held
+#define SOURCE_KEYBOARD 0
+#define SOURCE_COUNT (1 + MAX_GAMEPADS * 2)
+
+typedef struct InputEvent
+{
+	Uint64 time; // Performance counter value of when the event happened
+	Uint8 source;
+	Uint8 action;
+	bool down;
+} InputEvent;
+
+#pragma endregion
+
+#pragma region Globals
+
+// Events waiting for the tick that covers the time they happened
+static InputEvent queue[INPUT_QUEUE_SIZE];
+static int queueHead = 0;
+static int queueCount = 0;
+
+// Bit per action held by every source, and the actions pressed since the last tick
+static Uint8 held[SOURCE_COUNT];
+static Uint8 pressed = 0;
+
+// Open gamepads, and the directions their sticks point in as of the newest queued event
+static SDL_GameController* gamepads[MAX_GAMEPADS];
+static Uint8 stickDirections[MAX_GAMEPADS];
+
+// Time of the oldest event that has reached a tick but hasn't been presented yet, 0 if there is none
+static Uint64 latencyStart = 0;
+
+#pragma endregion
+
+#pragma region Helpers
+
+// Source index of the buttons or the stick of a gamepad
+static inline int getGamepadSource(int pad, bool stick)
+{
+	return 1 + pad * 2 + (stick ? 1 : 0);
+}
+
+// Find the slot of an open gamepad from its joystick instance id, -1 if it isn't open
+static int findGamepad(SDL_JoystickID id)
+{
+	for (int pad = 0; pad < MAX_GAMEPADS; pad++)
+		if (gamepads[pad] && SDL_JoystickInstanceID(SDL_GameControllerGetJoystick(gamepads[pad])) == id)
+			return pad;
+
+	return -1;
+}
+
+// Convert the millisecond timestamp of an event to a performance counter value
+static Uint64 getEventTime(const SDL_Event* event)
+{
+	Uint64 now = SDL_GetPerformanceCounter();
+	Uint64 age = (Uint64)(SDL_GetTicks() - event->common.timestamp) * SDL_GetPerformanceFrequency() / 1000;
+
+	return age < now ? now - age : 0;
+}
+
+// Apply an event to the state of its source
+static void applyEvent(const InputEvent* event)
+{
+	Uint8 bit = (Uint8)(1u << event->action);
+
+	if (event->down)
+	{
+		pressed |= bit;
+		held[event->source] |= bit;
+	}
+	else
+	{
+		held[event->source] &= (Uint8)~bit;
+	}
+
+	if (latencyStart == 0)
+		latencyStart = event->time;
+}
+
+// Add an event to the queue, making room by applying the oldest one if it's full
+static void queueEvent(Uint64 time, int source, InputAction action, bool down)
+{
+	if (queueCount == INPUT_QUEUE_SIZE)
+	{
+		applyEvent(&queue[queueHead]);
+		queueHead = (queueHead + 1) % INPUT_QUEUE_SIZE;
+		queueCount--;
+	}
+
+	queue[(queueHead + queueCount) % INPUT_QUEUE_SIZE] = (InputEvent){
+		.time = time,
+		.source = (Uint8)source,
+		.action = (Uint8)action,
+		.down = down,
+	};
+
+	queueCount++;
+}
+
+// Get the action of a key, false if the key isn't bound
+static bool getKeyAction(SDL_Scancode key, InputAction* action)
+{
+	switch (key)
+	{
+	case SDL_SCANCODE_LEFT: *action = ACTION_LEFT; return true;
+	case SDL_SCANCODE_RIGHT: *action = ACTION_RIGHT; return true;
+	case SDL_SCANCODE_SPACE: *action = ACTION_SHOOT; return true;
+	default: return false;
+	}
+}
+
+// Get the action of a gamepad button, false if the button isn't bound
+static bool getButtonAction(Uint8 button, InputAction* action)
+{
+	switch (button)
+	{
+	case SDL_CONTROLLER_BUTTON_DPAD_LEFT: *action = ACTION_LEFT; return true;
+	case SDL_CONTROLLER_BUTTON_DPAD_RIGHT: *action = ACTION_RIGHT; return true;
+	case SDL_CONTROLLER_BUTTON_A: *action = ACTION_SHOOT; return true;
+	default: return false;
+	}
+}
+
+// Open a newly connected gamepad in the first free slot
+static void openGamepad(int deviceIndex)
+{
+	if (!SDL_IsGameController(deviceIndex) || findGamepad(SDL_JoystickGetDeviceInstanceID(deviceIndex)) >= 0)
+		return;
+
+	for (int pad = 0; pad < MAX_GAMEPADS; pad++)
+	{
+		if (!gamepads[pad])
+		{
+			gamepads[pad] = SDL_GameControllerOpen(deviceIndex);
+			stickDirections[pad] = 0;
+			return;
+		}
+	}
+}
+
+// Close a disconnected gamepad and let go of everything it was holding
+static void closeGamepad(SDL_JoystickID id)
+{
+	int pad = findGamepad(id);
+	if (pad < 0)
+		return;
+
+	SDL_GameControllerClose(gamepads[pad]);
+	gamepads[pad] = NULL;
+
+	held[getGamepadSource(pad, false)] = 0;
+	held[getGamepadSource(pad, true)] = 0;
+	stickDirections[pad] = 0;
+}
+
+#pragma endregion
+
+// Function that clears the input state. Gamepads that are already connected arrive as device added events
+bool initInput(void)
+{
+	queueHead = 0;
+	queueCount = 0;
+	pressed = 0;
+	latencyStart = 0;
+
+	memset(held, 0, sizeof held);
+	memset(gamepads, 0, sizeof gamepads);
+	memset(stickDirections, 0, sizeof stickDirections);
+
+	return true;
+}
+
+// Close every open gamepad
+void quitInput(void)
+{
+	for (int pad = 0; pad < MAX_GAMEPADS; pad++)
+	{
+		if (gamepads[pad])
+			SDL_GameControllerClose(gamepads[pad]);
+
+		gamepads[pad] = NULL;
+	}
+}
+
+// Function that turns keyboard and gamepad events into queued actions
+bool handleInputEvent(const SDL_Event* event)
+{
+	InputAction action;
+
+	switch (event->type)
+	{
+	case SDL_KEYDOWN:
+	case SDL_KEYUP:
+		// Repeats don't change anything, the key is already held
+		if (!event->key.repeat && getKeyAction(event->key.keysym.scancode, &action))
+			queueEvent(getEventTime(event), SOURCE_KEYBOARD, action, event->type == SDL_KEYDOWN);
+		return true;
+
+	case SDL_CONTROLLERBUTTONDOWN:
+	case SDL_CONTROLLERBUTTONUP:
+	{
+		int pad = findGamepad(event->cbutton.which);
+		if (pad >= 0 && getButtonAction(event->cbutton.button, &action))
+			queueEvent(getEventTime(event), getGamepadSource(pad, false), action, event->type == SDL_CONTROLLERBUTTONDOWN);
+		return true;
+	}
+
+	case SDL_CONTROLLERAXISMOTION:
+	{
+		int pad = findGamepad(event->caxis.which);
+		if (pad < 0 || event->caxis.axis != SDL_CONTROLLER_AXIS_LEFTX)
+			return true;
+
+		// The stick only queues an event when it crosses the deadzone
+		Uint8 directions = 0;
+		if (event->caxis.value < -STICK_DEADZONE)
+			directions = 1u << ACTION_LEFT;
+		else if (event->caxis.value > STICK_DEADZONE)
+			directions = 1u << ACTION_RIGHT;
+
+		Uint8 changed = directions ^ stickDirections[pad];
+		Uint64 time = getEventTime(event);
+
+		for (int direction = ACTION_LEFT; direction <= ACTION_RIGHT; direction++)
+			if (changed & (1u << direction))
+				queueEvent(time, getGamepadSource(pad, true), (InputAction)direction, (directions >> direction) & 1u);
+
+		stickDirections[pad] = directions;
+		return true;
+	}
+
+	case SDL_CONTROLLERDEVICEADDED:
+		openGamepad(event->cdevice.which);
+		return true;
+
+	case SDL_CONTROLLERDEVICEREMOVED:
+		closeGamepad(event->cdevice.which);
+		return true;
+	}
+
+	return false;
+}
+
+// Function that applies every event that happened before the end of a tick and builds the input of that tick
+void readInput(PlayerInput* input, Uint64 tickEnd)
+{
+	while (queueCount > 0 && queue[queueHead].time <= tickEnd)
+	{
+		applyEvent(&queue[queueHead]);
+		queueHead = (queueHead + 1) % INPUT_QUEUE_SIZE;
+		queueCount--;
+	}
+
+	// An action is on when any source holds it, or when it was tapped since the last tick
+	Uint8 actions = pressed;
+	for (int source = 0; source < SOURCE_COUNT; source++)
+		actions |= held[source];
+
+	pressed = 0;
+
+	input->left = (actions >> ACTION_LEFT) & 1u;
+	input->right = (actions >> ACTION_RIGHT) & 1u;
+	input->shoot = (actions >> ACTION_SHOOT) & 1u;
+}
+
+// Function that hands the time of the oldest event that reached a tick to the next frame, which is the first to show it
+Uint64 takeInputLatencyStart(void)
+{
+	Uint64 start = latencyStart;
+	latencyStart = 0;
+
+	return start;
+}
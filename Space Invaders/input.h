@@ -0,0 +1,42 @@
+#pragma once
+
+// SDL libraries
+#include <SDL.h>
+
+// Game modules
+#include "game.h"
+
+// Helper libraries
+#include <stdbool.h>
+
+#pragma region Globals and defines
+
+// Events that haven't been given to a tick yet. The oldest is applied right away when the queue is full
+#define INPUT_QUEUE_SIZE 256
+
+// How far a stick has to be pushed before it counts as a direction, out of 32767
+#define STICK_DEADZONE 12000
+
+// Maximum amount of gamepads that are open at once
+#define MAX_GAMEPADS 4
+
+#pragma endregion
+
+#pragma region Function declarations
+
+// Initialization and exit, opens every gamepad that is already connected
+bool initInput(void);
+void quitInput(void);
+
+// Queue a keyboard or gamepad event with the time it happened. Returns false for events that aren't input
+bool handleInputEvent(const SDL_Event* event);
+
+// Fill the input of a tick from every event up to the performance counter value the tick ends at.
+// Presses that are let go again before the tick still count for it
+void readInput(PlayerInput* input, Uint64 tickEnd);
+
+// Time of the oldest event that has reached a tick since the last call, 0 if there is none.
+// The frame built next is the first to show its result, the latency is measured once that frame is presented
+Uint64 takeInputLatencyStart(void);
+
+#pragma endregion
@@ -0,0 +1,325 @@
+#include "kernels.h"
+
+// Standard libraries
+#include <string.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// SSE2 is part of every x64 CPU, AVX2 is checked for at startup
+#if defined(_M_X64) || defined(__x86_64__)
+#define KERNELS_X64
+#include <immintrin.h>
+#endif
+
+// Other compilers need to be told that a function may use AVX2, MSVC allows it anywhere
+#if defined(__GNUC__) || defined(__clang__)
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_AVX2
+#endif
+
+#pragma region Structs and globals
+
+// The kernels of one level
+typedef struct KernelTable
+{
+	void (*moveTagged)(float* values, const int* tags, float speed, float delta, int count);
+	void (*findOutside)(const float* values, int count, float low, float high, Uint32* mask);
+	int (*findOverlap)(const float* xs, const float* ys, int first, int last, float originX, float originY, int w, int h, const SDL_Rect* rect);
+} KernelTable;
+
+static const char* levelNames[KERNEL_LEVEL_COUNT] = { "scalar", "sse2", "avx2" };
+
+// Picked once at startup, before any thread runs a game
+static KernelLevel kernelLevel = KERNELS_SCALAR;
+
+#pragma endregion
+
+#pragma region Helpers
+
+// Index of the lowest set bit, the word must not be zero
+static inline int findFirstBit(Uint32 word)
+{
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward(&index, word);
+	return (int)index;
+#else
+	return __builtin_ctz(word);
+#endif
+}
+
+#pragma endregion
+
+#pragma region Scalar kernels
+
+static void moveTaggedScalar(float* values, const int* tags, float speed, float delta, int count)
+{
+	for (int i = 0; i < count; i++)
+		values[i] += (float)tags[i] * speed * delta;
+}
+
+// Helper function for setting the bits of values from the given index on
+static void findOutsideFrom(const float* values, int start, int count, float low, float high, Uint32* mask)
+{
+	for (int i = start; i < count; i++)
+		if (values[i] < low || values[i] > high)
+			mask[i >> 5] |= 1u << (i & 31);
+}
+
+static void findOutsideScalar(const float* values, int count, float low, float high, Uint32* mask)
+{
+	memset(mask, 0, sizeof(Uint32) * (size_t)((count + 31) / 32));
+	findOutsideFrom(values, 0, count, low, high, mask);
+}
+
+static int findOverlapScalar(const float* xs, const float* ys, int first, int last, float originX, float originY, int w, int h, const SDL_Rect* rect)
+{
+	for (int k = first; k < last; k++)
+	{
+		int x = (int)(originX + xs[k]);
+		int y = (int)(originY + ys[k]);
+
+		if (x < rect->x + rect->w && rect->x < x + w && y < rect->y + rect->h && rect->y < y + h)
+			return k;
+	}
+
+	return -1;
+}
+
+#pragma endregion
+
+#ifdef KERNELS_X64
+
+#pragma region SSE2 kernels
+
+static void moveTaggedSse2(float* values, const int* tags, float speed, float delta, int count)
+{
+	__m128 speeds = _mm_set1_ps(speed);
+	__m128 deltas = _mm_set1_ps(delta);
+
+	// Multiplied in the same order as the scalar kernel, so the results match bit for bit
+	int i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 step = _mm_mul_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)(tags + i))), speeds), deltas);
+		_mm_storeu_ps(values + i, _mm_add_ps(_mm_loadu_ps(values + i), step));
+	}
+
+	moveTaggedScalar(values + i, tags + i, speed, delta, count - i);
+}
+
+static void findOutsideSse2(const float* values, int count, float low, float high, Uint32* mask)
+{
+	memset(mask, 0, sizeof(Uint32) * (size_t)((count + 31) / 32));
+
+	__m128 lows = _mm_set1_ps(low);
+	__m128 highs = _mm_set1_ps(high);
+
+	// Groups of 4 start on a multiple of 4, so their bits never cross a word
+	int i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 v = _mm_loadu_ps(values + i);
+		Uint32 bits = (Uint32)_mm_movemask_ps(_mm_or_ps(_mm_cmplt_ps(v, lows), _mm_cmpgt_ps(v, highs)));
+
+		mask[i >> 5] |= bits << (i & 31);
+	}
+
+	findOutsideFrom(values, i, count, low, high, mask);
+}
+
+// Helper function for testing 4 boxes against the rectangle, a bit per box that overlaps it
+static inline Uint32 overlap4(const float* xs, const float* ys, __m128 originX, __m128 originY, __m128i w, __m128i h,
+	__m128i left, __m128i right, __m128i top, __m128i bottom)
+{
+	__m128i x = _mm_cvttps_epi32(_mm_add_ps(originX, _mm_loadu_ps(xs)));
+	__m128i y = _mm_cvttps_epi32(_mm_add_ps(originY, _mm_loadu_ps(ys)));
+
+	__m128i across = _mm_and_si128(_mm_cmplt_epi32(x, right), _mm_cmplt_epi32(left, _mm_add_epi32(x, w)));
+	__m128i down = _mm_and_si128(_mm_cmplt_epi32(y, bottom), _mm_cmplt_epi32(top, _mm_add_epi32(y, h)));
+
+	return (Uint32)_mm_movemask_ps(_mm_castsi128_ps(_mm_and_si128(across, down)));
+}
+
+static int findOverlapSse2(const float* xs, const float* ys, int first, int last, float originX, float originY, int w, int h, const SDL_Rect* rect)
+{
+	__m128 ox = _mm_set1_ps(originX);
+	__m128 oy = _mm_set1_ps(originY);
+	__m128i ws = _mm_set1_epi32(w);
+	__m128i hs = _mm_set1_epi32(h);
+
+	__m128i left = _mm_set1_epi32(rect->x);
+	__m128i right = _mm_set1_epi32(rect->x + rect->w);
+	__m128i top = _mm_set1_epi32(rect->y);
+	__m128i bottom = _mm_set1_epi32(rect->y + rect->h);
+
+	int k = first;
+	for (; k + 4 <= last; k += 4)
+	{
+		Uint32 bits = overlap4(xs + k, ys + k, ox, oy, ws, hs, left, right, top, bottom);
+		if (bits)
+			return k + findFirstBit(bits);
+	}
+
+	// Rows are often shorter than a group, so the rest is tested one box at a time rather than padded out
+	return findOverlapScalar(xs, ys, k, last, originX, originY, w, h, rect);
+}
+
+#pragma endregion
+
+#pragma region AVX2 kernels
+
+TARGET_AVX2 static void moveTaggedAvx2(float* values, const int* tags, float speed, float delta, int count)
+{
+	__m256 speeds = _mm256_set1_ps(speed);
+	__m256 deltas = _mm256_set1_ps(delta);
+
+	int i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256 step = _mm256_mul_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_loadu_si256((const __m256i*)(tags + i))), speeds), deltas);
+		_mm256_storeu_ps(values + i, _mm256_add_ps(_mm256_loadu_ps(values + i), step));
+	}
+
+	moveTaggedScalar(values + i, tags + i, speed, delta, count - i);
+}
+
+TARGET_AVX2 static void findOutsideAvx2(const float* values, int count, float low, float high, Uint32* mask)
+{
+	memset(mask, 0, sizeof(Uint32) * (size_t)((count + 31) / 32));
+
+	__m256 lows = _mm256_set1_ps(low);
+	__m256 highs = _mm256_set1_ps(high);
+
+	int i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256 v = _mm256_loadu_ps(values + i);
+		__m256 outside = _mm256_or_ps(_mm256_cmp_ps(v, lows, _CMP_LT_OQ), _mm256_cmp_ps(v, highs, _CMP_GT_OQ));
+
+		mask[i >> 5] |= (Uint32)_mm256_movemask_ps(outside) << (i & 31);
+	}
+
+	findOutsideFrom(values, i, count, low, high, mask);
+}
+
+// Helper function for testing 8 boxes against the rectangle, a bit per box that overlaps it
+TARGET_AVX2 static inline Uint32 overlap8(const float* xs, const float* ys, __m256 originX, __m256 originY, __m256i w, __m256i h,
+	__m256i left, __m256i right, __m256i top, __m256i bottom)
+{
+	__m256i x = _mm256_cvttps_epi32(_mm256_add_ps(originX, _mm256_loadu_ps(xs)));
+	__m256i y = _mm256_cvttps_epi32(_mm256_add_ps(originY, _mm256_loadu_ps(ys)));
+
+	// AVX2 only has a greater than compare, so every test is written the other way around
+	__m256i across = _mm256_and_si256(_mm256_cmpgt_epi32(right, x), _mm256_cmpgt_epi32(_mm256_add_epi32(x, w), left));
+	__m256i down = _mm256_and_si256(_mm256_cmpgt_epi32(bottom, y), _mm256_cmpgt_epi32(_mm256_add_epi32(y, h), top));
+
+	return (Uint32)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_and_si256(across, down)));
+}
+
+TARGET_AVX2 static int findOverlapAvx2(const float* xs, const float* ys, int first, int last, float originX, float originY, int w, int h, const SDL_Rect* rect)
+{
+	__m256 ox = _mm256_set1_ps(originX);
+	__m256 oy = _mm256_set1_ps(originY);
+	__m256i ws = _mm256_set1_epi32(w);
+	__m256i hs = _mm256_set1_epi32(h);
+
+	__m256i left = _mm256_set1_epi32(rect->x);
+	__m256i right = _mm256_set1_epi32(rect->x + rect->w);
+	__m256i top = _mm256_set1_epi32(rect->y);
+	__m256i bottom = _mm256_set1_epi32(rect->y + rect->h);
+
+	int k = first;
+	for (; k + 8 <= last; k += 8)
+	{
+		Uint32 bits = overlap8(xs + k, ys + k, ox, oy, ws, hs, left, right, top, bottom);
+		if (bits)
+			return k + findFirstBit(bits);
+	}
+
+	// The scalar tail isn't built for AVX, the upper halves are cleared first so it doesn't pay for switching between the two
+	_mm256_zeroupper();
+	return findOverlapScalar(xs, ys, k, last, originX, originY, w, h, rect);
+}
+
+#pragma endregion
+
+#endif
+
+// Every level, levels the build doesn't have fall back to the scalar kernels
+static const KernelTable kernelTables[KERNEL_LEVEL_COUNT] = {
+	[KERNELS_SCALAR] = { moveTaggedScalar, findOutsideScalar, findOverlapScalar },
+#ifdef KERNELS_X64
+	[KERNELS_SSE2] = { moveTaggedSse2, findOutsideSse2, findOverlapSse2 },
+	[KERNELS_AVX2] = { moveTaggedAvx2, findOutsideAvx2, findOverlapAvx2 },
+#else
+	[KERNELS_SSE2] = { moveTaggedScalar, findOutsideScalar, findOverlapScalar },
+	[KERNELS_AVX2] = { moveTaggedScalar, findOutsideScalar, findOverlapScalar },
+#endif
+};
+
+// Function for getting the kernel options from the command line
+void parseKernelOptions(int argc, char* argv[], KernelOptions* options)
+{
+	options->level = KERNELS_AVX2;
+
+	for (int i = 1; i < argc - 1; i++)
+	{
+		if (strcmp(argv[i], "--simd") == 0)
+		{
+			const char* level = argv[++i];
+
+			for (int l = 0; l < KERNEL_LEVEL_COUNT; l++)
+				if (strcmp(level, levelNames[l]) == 0)
+					options->level = (KernelLevel)l;
+		}
+	}
+}
+
+// Function that checks which instruction sets the CPU has
+KernelLevel getSupportedKernelLevel(void)
+{
+#ifdef KERNELS_X64
+	return SDL_HasAVX2() ? KERNELS_AVX2 : KERNELS_SSE2;
+#else
+	return KERNELS_SCALAR;
+#endif
+}
+
+// Function that picks the widest kernels that were asked for and that the CPU supports
+KernelLevel initKernels(const KernelOptions* options)
+{
+	KernelLevel supported = getSupportedKernelLevel();
+
+	kernelLevel = options->level < supported ? options->level : supported;
+	return kernelLevel;
+}
+
+KernelLevel getKernelLevel(void)
+{
+	return kernelLevel;
+}
+
+// Function for getting the printable name of a kernel level
+const char* getKernelLevelName(KernelLevel level)
+{
+	return levelNames[level];
+}
+
+void moveTagged(float* values, const int* tags, float speed, float delta, int count)
+{
+	kernelTables[kernelLevel].moveTagged(values, tags, speed, delta, count);
+}
+
+void findOutside(const float* values, int count, float low, float high, Uint32* mask)
+{
+	kernelTables[kernelLevel].findOutside(values, count, low, high, mask);
+}
+
+int findOverlap(const float* xs, const float* ys, int first, int last, float originX, float originY, int w, int h, const SDL_Rect* rect)
+{
+	return kernelTables[kernelLevel].findOverlap(xs, ys, first, last, originX, originY, w, h, rect);
+}
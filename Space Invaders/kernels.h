@@ -0,0 +1,45 @@
+#pragma once
+
+// SDL libraries
+#include <SDL.h>
+
+// Helper libraries
+#include <stdbool.h>
+
+#pragma region Structs and ENUMs
+
+// Instruction sets the kernels are written for, from narrowest to widest. Every level gives bit-identical results
+typedef enum KernelLevel { KERNELS_SCALAR, KERNELS_SSE2, KERNELS_AVX2, KERNEL_LEVEL_COUNT } KernelLevel;
+
+// Widest level given with "--simd scalar|sse2|avx2", the kernels never go past what the CPU supports
+typedef struct KernelOptions
+{
+	KernelLevel level;
+} KernelOptions;
+
+#pragma endregion
+
+#pragma region Function declarations
+
+// Parse kernel options from the command line
+void parseKernelOptions(int argc, char* argv[], KernelOptions* options);
+
+// Pick the kernels once at startup, before any game runs. Returns the level that was picked
+KernelLevel initKernels(const KernelOptions* options);
+KernelLevel getKernelLevel(void);
+const char* getKernelLevelName(KernelLevel level);
+
+// Widest level the CPU supports
+KernelLevel getSupportedKernelLevel(void);
+
+// Move every value along its tag: values[i] += tags[i] * speed * delta
+void moveTagged(float* values, const int* tags, float speed, float delta, int count);
+
+// Set a bit in the mask for every value below low or above high. The mask needs (count + 31) / 32 words
+void findOutside(const float* values, int count, float low, float high, Uint32* mask);
+
+// Find the first box in [first, last) that overlaps the rectangle, -1 if none does.
+// A box is placed at the whole pixel below origin + xs/ys and is w by h, like the rectangles SDL_HasIntersection tests
+int findOverlap(const float* xs, const float* ys, int first, int last, float originX, float originY, int w, int h, const SDL_Rect* rect);
+
+#pragma endregion
@@ -0,0 +1,66 @@
+#include "logging.h"
+
+// Standard libraries
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#pragma region Globals and defines
+
+// Size of the buffer and of the longest line
+#define LOG_BUFFER_SIZE 8192
+#define MAX_LOG_LINE 256
+
+bool loggingEnabled = false;
+
+static char logBuffer[LOG_BUFFER_SIZE];
+static size_t logLength = 0;
+
+#pragma endregion
+
+// Function that turns logging on or off
+void enableLogging(bool enabled)
+{
+	if (!enabled)
+		flushLog();
+
+	loggingEnabled = enabled;
+}
+
+// Function that formats a line into the log buffer, printing the buffer first if the line doesn't fit
+void logMessage(const char* format, ...)
+{
+	if (!loggingEnabled)
+		return;
+
+	char line[MAX_LOG_LINE];
+
+	va_list args;
+	va_start(args, format);
+	int length = vsnprintf(line, sizeof line - 1, format, args);
+	va_end(args);
+
+	if (length < 0)
+		return;
+	if (length > MAX_LOG_LINE - 2)
+		length = MAX_LOG_LINE - 2;
+
+	line[length++] = '\n';
+
+	if (logLength + length > LOG_BUFFER_SIZE)
+		flushLog();
+
+	memcpy(logBuffer + logLength, line, length);
+	logLength += length;
+}
+
+// Function that prints everything in the log buffer
+void flushLog(void)
+{
+	if (logLength == 0)
+		return;
+
+	fwrite(logBuffer, 1, logLength, stdout);
+	fflush(stdout);
+	logLength = 0;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+// Helper libraries
+#include <stdbool.h>
+
+#pragma region Globals and defines
+
+// Whether log messages are kept, off unless asked for on the command line
+extern bool loggingEnabled;
+
+// Log a message from the hot path. Costs only a branch when logging is off
+#define LOG_MESSAGE(...) do { if (loggingEnabled) logMessage(__VA_ARGS__); } while (0)
+
+#pragma endregion
+
+#pragma region Function declarations
+
+void enableLogging(bool enabled);
+
+// Add a line to the log buffer, which is printed when it fills up or is flushed
+void logMessage(const char* format, ...);
+void flushLog(void);
+
+#pragma endregion
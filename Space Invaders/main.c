@@ -1,8 +1,22 @@
 // SDL libraries
 #include <SDL.h>
-#include <SDL_mixer.h>
-#include <SDL_ttf.h>
-#include <SDL_image.h>
+
+// Game modules
+#include "assets.h"
+#include "audio.h"
+#include "batch.h"
+#include "game.h"
+#include "headless.h"
+#include "input.h"
+#include "kernels.h"
+#include "logging.h"
+#include "netplay.h"
+#include "pacing.h"
+#include "profiler.h"
+#include "render.h"
+#include "replay.h"
+#include "scores.h"
+#include "telemetry.h"
 
 // Standard libraries
 #include <stdlib.h>
@@ -12,199 +26,170 @@
 #include <stdbool.h>
 #include <time.h>
 
-#pragma region Structs and ENUMs
-
-typedef struct Enemy
-{
-	float px, py; // Coordinates
-
-	int killReward; // Amount of points player gets for kiling enemy
-	float shootTimer; // Cooldown for shooting bullets
-} Enemy;
-
-typedef struct Player
-{
-	float px, py; // Coordinates
-
-	int score; // Current score
-	int hiScore; // High-score
-
-	int livesLeft; // Amount of lives left until game resets
-	float shootTimer; // Cooldown for shooting bullets
-} Player;
-
-
-typedef struct Bullet
-{
-	float px, py; // Coordinates
-
-	int vy; // Y-velocity, used for determining the direction (up or down) of the bullet.
-
-} Bullet;
-
-typedef enum ParticleTypes {BULLET_EXPLOSION, SHIP_EXPLOSION} ParticleTypes; // Types of particles
-
-typedef struct Particle 
-{
-	float px, py; // Coordinates
-
-	float lifetime; // Lifetime of particle (how long particle stays on screen)
-
-	ParticleTypes particleType; // The type of particle
-} Particle;
-
-#pragma endregion
-
 #pragma region Globals and defines
 
-// Window size
-#define WINDOW_WIDTH 640
-#define WINDOW_HEIGHT 480
-
-// Maximums for enemies, projectiles (bullets) and particles
-#define MAX_ENEMIES 55
-#define MAX_PROJECTILES 20
-#define MAX_PARTICLES 20
-
-// Speed offset
-#define BASE_ENEMY_SPEED_OFFSET 0.0f;
-float ENEMY_SPEED_OFFSET = BASE_ENEMY_SPEED_OFFSET;
-const float ENEMY_SPEED_OFFSET_INCR = 1.25f;
-
-
-// Speed variables for all entities
-unsigned const int PLAYER_SPEED = 200;
-unsigned const int ENEMY_SPEED = 20;
-unsigned const int BULLET_SPEED = 275;
-
-// Shooting
-const float SHOOT_COOLDOWN = 0.75f;
-const float PLAYER_SHOOT_OFFSET = 1.30f;
-
-// Enemy speed multiplier, used for increasing speed every time enemies change direciton
-float ENEMY_SPEED_MULT = 1.0f;
-
-// Player size
-const float PLAYER_WIDTH = 20.0f;
-const float PLAYER_HEIGHT = 20.0f;
-
-// Enemy size
-const float ENEMY_WIDTH = 30;
-const float ENEMY_HEIGHT = 30;
-
-// Bullet (projectile) size
-const float BULLET_WIDTH = 10;
-const float BULLET_HEIGHT = 15;
-
-// Particle size
-const float PARTICLE_WIDTH = 20;
-const float PARTICLE_HEIGHT = 20;
-
-// Player object
-Player player;
+// Longest frame that is simulated, so a stall doesn't cause a long burst of catch-up ticks
+#define MAX_FRAME_TIME 0.25
 
-// Global pointers for storing enemies, bullets and particles
-Enemy* enemies[MAX_ENEMIES] = { NULL };
-Bullet* bullets[MAX_PROJECTILES] = { NULL };
-Particle* particles[MAX_PARTICLES] = { NULL };
+// Shutdowns slower than this are reported with the part that took longest, in milliseconds
+#define SLOW_SHUTDOWN_TIME 100.0
 
-// Global pointers for SDL
-SDL_Window* window = NULL;
-SDL_Renderer* renderer = NULL;
+#ifndef HEADLESS
 
-// Global pointers for sound effects
-Mix_Chunk* shoot_sound = NULL;
-Mix_Chunk* hit_sound = NULL;
+// Recording of the session and the recording being replayed, if requested on the command line
+InputRecorder recorder;
+InputReplay replay;
 
-// Global pointers of the textures of the entities
-SDL_Texture* enemy_tex = NULL;
-SDL_Texture* bullet_tex = NULL;
-SDL_Texture* particle_textures[2];
+// Where the profile is written on exit
+ProfilerOptions profilerOptions;
 
-// Global pointer for the game and menu font 
-TTF_Font* game_font;
-TTF_Font* menu_font;
+// Whether the game was started with a non-default size, the frame time is printed on exit then
+bool stressRun = false;
 
-// Current enemy direction and wave number
-int enemyDir = 1;
-int currentWave = 1;
+// State saved with F5 and loaded with F9, allocated on the first save
+WorldSnapshot quickSave;
 
-// Boolean used for determining if the game is over
-static bool gameOver = false;
+// Set once the program has been torn down, so nothing is freed twice
+bool exited = false;
 
-static bool playGame = false;
+#endif
 
 #pragma endregion
 
 #pragma region Function forward declarations
 
 // Initialization and exit
-bool init(void);
+bool init(const ReplayOptions* options, const AssetOptions* assets, const AudioOptions* audio, const GameConfig* config, const PacingOptions* pacing,
+	const ScoreOptions* scores, const TelemetryOptions* telemetry, const DisplayOptions* display, const NetOptions* net);
 void exitProgram(void);
+void finishSession(void);
+void freeWorlds(void);
 
-// Main update methods
-void update(float delta);
+// Input
+void readTickInput(PlayerInput* input, Uint64 tickEnd);
 
-// Player methods
-void createPlayer(Player* player);
-void updatePlayer(Player* player, float delta);
-
-// Enemy methods
-void createEnemies(void);
-void updateEnemies(float delta);
-void enemyShoot(float delta);
-
-// Bullet methods
-void createBullet(int px, int py, int dir);
-void updateBullets(float delta);
-
-// Particle methods
-void createParticle(Particle particle);
-void updateParticles(float delta);
-
-// Collision checking and game state checking
-void checkBulletCollisions(Player* player);
-void checkGameState(Player* player);
-
-// Rendering
-void drawText(const char* text, TTF_Font* font, SDL_Color color, int px, int py);
-void renderEntities(void);
-void renderStats(void);
-
-// Freeing memory used by global pointers
-void freeEnemies(void);
-void freeBullets(void);
-void freeParticles(void);
-
-// Menu functions
-void renderMenu(void);
-void checkGameStart(void);
+// Saving and loading the state
+void saveQuickState(void);
+void loadQuickState(void);
 
 #pragma endregion	
 
 int main(int argc, char* argv[])
 {
-	// If initialization is unsuccessful, exit the program
-	if (!init()) {
-		exitProgram();
-	}
+	// Pick the vector kernels before anything simulates, capped by "--simd"
+	KernelOptions kernelOptions;
+	parseKernelOptions(argc, argv, &kernelOptions);
+	initKernels(&kernelOptions);
+
+#ifdef HOT_TUNABLES
+	// Dev builds read the tunables from a file, before anything is sized or simulated from them
+	TunablesOptions tunablesOptions;
+	parseTunablesOptions(argc, argv, &tunablesOptions);
+	if (!initTunables(&tunablesOptions))
+		return 1;
+#endif
+
+	// Run only the game logic if headless mode was requested, or if this is a headless build
+	HeadlessOptions headlessOptions;
+	bool headless = parseHeadlessOptions(argc, argv, &headlessOptions);
+
+	// A batch of games is always run without a window, with the headless controller and config
+	BatchOptions batchOptions;
+	if (parseBatchOptions(argc, argv, &batchOptions))
+		return runBatch(&batchOptions, &headlessOptions);
+
+	if (headless)
+		return runHeadless(&headlessOptions);
+
+#ifndef HEADLESS
+	AssetOptions assetOptions;
+	parseAssetOptions(argc, argv, &assetOptions);
+
+	// Build the asset pack from the loose files instead of playing
+	if (assetOptions.writePath)
+		return writeAssetPack(assetOptions.writePath) ? 0 : 1;
+
+	ReplayOptions replayOptions;
+	parseReplayOptions(argc, argv, &replayOptions);
+
+	AudioOptions audioOptions;
+	parseAudioOptions(argc, argv, &audioOptions);
+
+	// Formation size and entity caps, larger than the default in stress runs
+	GameConfig gameOptions;
+	stressRun = parseGameConfig(argc, argv, &gameOptions);
+
+	// Vsync, uncapped or frame-limited presentation
+	PacingOptions pacingOptions;
+	parsePacingOptions(argc, argv, &pacingOptions);
+
+	// Fullscreen or a window of a whole scale, the game is drawn at its logical size either way
+	DisplayOptions displayOptions;
+	parseDisplayOptions(argc, argv, &displayOptions);
+
+	// Where the high scores are kept
+	ScoreOptions scoreOptions;
+	parseScoreOptions(argc, argv, &scoreOptions);
+
+	// Where the gameplay and performance metrics of the session go, if anywhere
+	TelemetryOptions telemetryOptions;
+	parseTelemetryOptions(argc, argv, &telemetryOptions);
+
+	// Co-op over the network, or watching a co-op game. Recordings only hold the input of one player, so they're off in a session
+	NetOptions netOptions;
+	parseNetOptions(argc, argv, &netOptions);
+
+	if (netOptions.role != NET_OFF)
+	{
+		if (replayOptions.recordPath || replayOptions.replayPath)
+			printf("Recording and replaying are off during netplay\n");
 
-	atexit(exitProgram);
+		replayOptions = (ReplayOptions){ NULL };
+		gameOptions.players = 2;
+	}
 
-	// Load textures
-	enemy_tex = IMG_LoadTexture(renderer, "enemy.png");
-	bullet_tex = IMG_LoadTexture(renderer, "bullet.png");
-	particle_textures[0] = IMG_LoadTexture(renderer, "bullet_destroy_particle.png");
-	particle_textures[1] = IMG_LoadTexture(renderer, "ship_destroy_particle.png");
+	// The windowed game is always timed, so the overlay can be opened at any point
+	parseProfilerOptions(argc, argv, &profilerOptions);
+	enableLogging(profilerOptions.logging);
+	setProfiling(true);
 
+	// If initialization is unsuccessful, exit the program
+	if (!init(&replayOptions, &assetOptions, &audioOptions, &gameOptions, &pacingOptions, &scoreOptions, &telemetryOptions, &displayOptions, &netOptions)) {
+		exitProgram();
+		return 1;
+	}
 
 	SDL_Event event;
 	bool quit = false;
 
-	Uint32 lastFrame = SDL_GetTicks();
+	// Time that has passed but hasn't been simulated yet
+	const Uint64 frequency = SDL_GetPerformanceFrequency();
+	Uint64 lastFrame = SDL_GetPerformanceCounter();
+	double accumulator = 0.0;
 
 	while (!quit)
 	{
+		// The limiter waits before input is read rather than after presenting, so every frame starts from the freshest input.
+		// Frames are also held back until the render thread has taken the last one, instead of being built only to be dropped
+		waitForNextFrame();
+		waitForRenderThread();
+
+		beginPhase(PHASE_FRAME);
+
+#ifdef HOT_TUNABLES
+		// A saved tunables file applies from the next tick on, the balance of the world follows unless the command line set it,
+		// and the waves from the next one
+		// Recordings, replays and sessions are checked against the tunables they started with and have to keep simulating with the same
+		// values, so the file isn't read during them. The quick save was taken with the old config and no longer fits the world, so it's dropped
+		Tunables previousTunables;
+		if (!isNetplayActive() && !recorder.file && !replay.data && pollTunables(&previousTunables))
+		{
+			refreshGameConfig(&gameWorld.config, &previousTunables);
+			createWaveSchedule(&gameWorld);
+			freeSnapshot(&quickSave);
+		}
+#endif
+
 		while (SDL_PollEvent(&event))
 		{
 			switch (event.type)
@@ -212,689 +197,300 @@ int main(int argc, char* argv[])
 			case SDL_QUIT:
 				quit = true;
 				break;
+			case SDL_KEYDOWN:
+				// Toggle the profiler overlay
+				if (event.key.keysym.sym == SDLK_F3 && !event.key.repeat)
+					showProfiler = !showProfiler;
+
+				// Cycle through the present modes, the render thread switches vsync with the next frame
+				if (event.key.keysym.sym == SDLK_F4 && !event.key.repeat)
+					setPresentMode((PresentMode)((getPresentMode() + 1) % PRESENT_MODE_COUNT));
+
+				// Save and load the state of the game
+				if (event.key.keysym.sym == SDLK_F5 && !event.key.repeat)
+					saveQuickState();
+				if (event.key.keysym.sym == SDLK_F9 && !event.key.repeat)
+					loadQuickState();
+
+				handleInputEvent(&event);
+				break;
+			case SDL_RENDER_TARGETS_RESET:
+			case SDL_RENDER_DEVICE_RESET:
+				// Cached text layers lost their contents
+				invalidateTextLayers();
+				break;
+			default:
+				// Keys and gamepads are queued with the time they happened, and given to the tick that covers that time
+				handleInputEvent(&event);
+				break;
 			}
 		}
 
-		Uint32 curFrame = SDL_GetTicks();
+		Uint64 curFrame = SDL_GetPerformanceCounter();
 
-		Uint32 difference = curFrame - lastFrame;
-		float delta = difference / 1000.0f;
+		double frameTime = (double)(curFrame - lastFrame) / (double)frequency;
+		double realFrameTime = frameTime;
+		if (frameTime > MAX_FRAME_TIME)
+			frameTime = MAX_FRAME_TIME;
 
 		lastFrame = curFrame;
+		accumulator += frameTime;
 
-		update(delta);
-	}
-
-	return 0;
-}
-
-// Function that initializes everything for the program to run correctly
-bool init(void)
-{
-	bool success = true;
-
-	// Initialize base SDL library
-	if (SDL_Init(SDL_INIT_EVERYTHING) != 0) {
-		printf("Couldn't initialize SDL: %s", SDL_GetError());
-		success = false;
-	}
-
-	// Initialize the TTF library (text rendering)
-	if (TTF_Init() != 0) {
-		printf("Couldn't initialize SDL: %s", TTF_GetError());
-		success = false;
-	}
-
-	// Initialize the Mix library (audio playback)
-	if (Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 2048) < 0) {
-		printf("SDL_mixer could not initialize! SDL_mixer Error: %s\n", Mix_GetError());
-		success = false;
-	}
-	
-	if ((IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG) != IMG_INIT_PNG) {
-		printf("SDL_image could not initialize! SDL_image Error: %s", IMG_GetError());
-		success = false;
-	}
-
-	// Lower mixer volume
-	Mix_Volume(-1, 64);
-
-	// Set render scale quality to 0 for the crispiest pixel art
-	SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "0");
-
-	// Load the game and menu fonts
-	game_font = TTF_OpenFont("rubik-reg.ttf", 18);
-	menu_font = TTF_OpenFont("rubik-reg.ttf", 64);
-
-	// Load the two sound effects
-	shoot_sound = Mix_LoadWAV("shoot_sound.wav");
-	hit_sound = Mix_LoadWAV("hit_sound.wav");
-
-	// Create a window and a renderer
-	window = SDL_CreateWindow("Space Invaders", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, WINDOW_WIDTH, WINDOW_HEIGHT, 0);
-	renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+		// Run as many fixed ticks as the elapsed time covers
+		while (accumulator >= TICK_TIME)
+		{
+			// Every tick covers the real time up to where the accumulator would be after it
+			Uint64 tickEnd = curFrame - (Uint64)((accumulator - TICK_TIME) * (double)frequency);
 
-	// Create player and enemies
-	createPlayer(&player);
-	createEnemies();
+			// A session may have to wait for the other player. The tick is skipped then, and its input stays queued for the next one that runs
+			if (isNetplayActive() && !readyForNetplayTick(&gameWorld))
+			{
+				accumulator -= TICK_TIME;
+				continue;
+			}
 
-	// Set a seed for pseudo-random number generation
-	srand((unsigned int)time(0));
+			PlayerInput input;
+			beginPhase(PHASE_INPUT);
+			readTickInput(&input, tickEnd);
+			endPhase(PHASE_INPUT);
 
-	// Return bool indicating the success of initailizing everything
-	return success;
-}
+			Uint64 tickStart = SDL_GetPerformanceCounter();
+			if (!isNetplayActive())
+				update(&gameWorld, &input, (float)TICK_TIME);
+			else
+				advanceNetplay(&gameWorld, &input);
+			recordTelemetryTick(tickStart);
 
-// Function that gets called when the program exits
-void exitProgram(void)
-{
-	// Free memory
-	SDL_DestroyWindow(window);
-	SDL_DestroyRenderer(renderer);
-	TTF_CloseFont(game_font);
-
-	SDL_DestroyTexture(enemy_tex);
-	SDL_DestroyTexture(particle_textures);
-	SDL_DestroyTexture(bullet_tex);
-
-	Mix_FreeChunk(hit_sound);
-	Mix_FreeChunk(shoot_sound);
-
-	freeBullets();
-	freeEnemies();
-	freeParticles();
-
-	// Quit libraries
-	Mix_Quit();
-	TTF_Quit();
-	IMG_Quit();
-	SDL_Quit();
-}
+			accumulator -= TICK_TIME;
+		}
 
-// Main update function that calls all other function
-void update(float delta) 
-{
-	SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-	SDL_RenderClear(renderer);
+		// The inputs of the frame go out in one packet
+		flushNetplay();
 
-	if(playGame) 
-	{
-		updatePlayer(&player, delta);
-		updateBullets(delta);
-		updateParticles(delta);
+		// The telemetry takes the shots and kills of the frame, and the end of a game before the high scores clear it
+		recordTelemetryFrame(&gameWorld, realFrameTime, takeDroppedFrames());
 
-		enemyShoot(delta);
+		// A game that ended goes into the high scores. Replays were already played once and other configs don't compare, so their games don't,
+		// and neither do co-op games
+		recordFinishedGame(&gameWorld, !replay.data && !stressRun && !isNetplayActive());
 
-		checkBulletCollisions(&player);
-		checkGameState(&player);
+		// Play the sounds of every tick of this frame at once
+		playWorldSounds(&gameWorld);
+		flushAudio();
 
-		updateEnemies(delta);
+		// Hand the state between the last two ticks to the render thread, which draws and presents it on its own
+		render((float)(accumulator / TICK_TIME));
 
-		renderStats();
-		renderEntities();
-	}
-	else 
-	{
-		renderMenu();
-		checkGameStart();
+		endPhase(PHASE_FRAME);
 	}
 
-	SDL_RenderPresent(renderer);
-}
+	exitProgram();
+#endif
 
-// Function for creating the player
-void createPlayer(Player* player)
-{
-	// Initialize variables
-	player->px = WINDOW_WIDTH / 2;
-	player->py = WINDOW_HEIGHT - (WINDOW_HEIGHT / 14);
-	
-	player->score = 0;
-	player->hiScore = 0;
-	
-	player->livesLeft = 3;
-	player->shootTimer = 0.0;
+	return 0;
 }
 
-// Function for updating the player
-void updatePlayer(Player* player, float delta)
-{
-	// Get keyboard state
-	const Uint8* state = SDL_GetKeyboardState(NULL);
+#ifndef HEADLESS
 
-	// Move right
-	if (state[SDL_SCANCODE_RIGHT])
-	{
-		player->px += PLAYER_SPEED * delta;
-	}
+// Function that initializes everything for the program to run correctly
+bool init(const ReplayOptions* options, const AssetOptions* assets, const AudioOptions* audio, const GameConfig* config, const PacingOptions* pacing,
+	const ScoreOptions* scores, const TelemetryOptions* telemetry, const DisplayOptions* display, const NetOptions* net)
+{
+	bool success = true;
 
-	// Move left
-	if (state[SDL_SCANCODE_LEFT])
-	{
-		player->px -= PLAYER_SPEED * delta;
-	}
+	// A replay has to start from the seed and the config it was recorded with
+	unsigned int seed = (unsigned int)time(0);
+	GameConfig gameConfig = *config;
 
-	// Shoot
-	if (state[SDL_SCANCODE_SPACE])
+	if (options->replayPath)
 	{
-		if (player->shootTimer <= 0)
-		{
-			createBullet((int)player->px, (int)player->py, -1);
-			Mix_PlayChannel(-1, shoot_sound, 0);
-
-			player->shootTimer = 1.0;
-		}
+		if (loadReplay(&replay, options->replayPath, &gameConfig))
+			seed = replay.seed;
+		else
+			success = false;
 	}
 
-	player->shootTimer -= delta * PLAYER_SHOOT_OFFSET;
-}
+	if (options->recordPath && !startRecording(&recorder, options->recordPath, seed, &gameConfig))
+		success = false;
 
-// Function for creating a new set of enemies
-void createEnemies(void)
-{
-	for(unsigned int i = 0; i < MAX_ENEMIES; i++) 
-	{
-		// Allocate memory
-		enemies[i] = (Enemy*)malloc(sizeof(Enemy));
-
-		// Get row and column
-		int px = i % 11;
-		int py = i / 11;
-
-		// Initialize variables if malloc succeeded
-		if (enemies[i])
-		{			
-			enemies[i]->px = (float)px * ENEMY_WIDTH + (10.0f * (float)px) + 100;
-			enemies[i]->py = (float)py * ENEMY_HEIGHT + (10.0f * (float)py) + 100;
-			enemies[i]->killReward = 10 * currentWave;
-			enemies[i]->shootTimer = max(0.20f, 1 - (0.05f * currentWave));
-		}
+	// Initialize base SDL library
+	if (SDL_Init(SDL_INIT_EVERYTHING) != 0) {
+		printf("Couldn't initialize SDL: %s", SDL_GetError());
+		success = false;
 	}
-}
 
-// Function for updating enemies
-void updateEnemies(float delta)
-{
-	bool moveDown = false;
-	for (unsigned int i = 0; i < MAX_ENEMIES; i++)
-	{
-		// If enemy exists...
-		if (enemies[i] != NULL)
-		{
-			// Move right if 1, else left
-			if (enemyDir == 1)
-				enemies[i]->px += ((float)ENEMY_SPEED + ENEMY_SPEED_OFFSET) * ENEMY_SPEED_MULT * delta;
-			else
-				enemies[i]->px -= ((float)ENEMY_SPEED + ENEMY_SPEED_OFFSET) * ENEMY_SPEED_MULT * delta;
+	// Joining players and spectators play with the seed of the host
+	if (!initNetplay(net, &gameConfig, &seed))
+		return false;
 
-			// If an enemy is too close to either edge, change to direction of every enemey
-			if (enemies[i]->px < 0 + (ENEMY_WIDTH) || enemies[i]->px > WINDOW_WIDTH -  (ENEMY_WIDTH))
-			{
-				moveDown = !moveDown;
-			}
-
-			// If enemies get too close to player, end the game
-			if (enemies[i]->py > WINDOW_HEIGHT - PLAYER_HEIGHT * 2 - ENEMY_HEIGHT)
-				gameOver = true;
-		}
-	}
-
-	if (moveDown) {
-		// Inverse direction
-		enemyDir = -enemyDir;
+	// Keyboard and gamepad state
+	if (!initInput())
+		success = false;
 
-		// Move enemies down by 1/4 of their height
-		for (unsigned int i = 0; i < MAX_ENEMIES; i++)
-			if (enemies[i] != NULL)
-				enemies[i]->py += ENEMY_HEIGHT / 4;
-	}
-}
+	// Frame limiter
+	if (!initPacing(pacing))
+		success = false;
 
-// Function that makes enemies shoot on a semi-random basis
-void enemyShoot(float delta)
-{
-	int index = MAX_ENEMIES - 1;
-	int found[] = { 0,0,0,0,0,0,0,0,0,0,0 };
+	// Stop right away when an asset is missing, before the window opens
+	if (!loadAssets(assets->packPath))
+		return false;
 
-	for (int i = 0; i < 5; i++)
-	{
-		for(int j = 0; j < 11; j++) 
-		{
-			if (enemies[index] != NULL && found[j] != 1)
-			{
-				found[j] = 1;
+	// Initialize audio playback and load the sound effects
+	if (!initAudio(audio))
+		success = false;
 
-				if (rand() % 5000 < 10 && enemies[index]->shootTimer <= 0)
-				{
-					createBullet((int)enemies[index]->px, (int)enemies[index]->py, 1);
+	// Load the high scores, they are written on a thread of their own from then on
+	if (!initScores(scores))
+		success = false;
 
+	// Open the telemetry file and start its writer thread
+	if (!initTelemetry(telemetry))
+		success = false;
 
-					Mix_PlayChannel(-1, shoot_sound, 0);
+	// Create player and enemies with a seed for pseudo-random number generation
+	if (!initGame(&gameWorld, seed, &gameConfig))
+		success = false;
 
-					enemies[index]->shootTimer = SHOOT_COOLDOWN;
-				}
+	// The host waits for its partner here, before the window opens
+	if (success && !startNetplay(&gameWorld))
+		success = false;
 
-				enemies[index]->shootTimer -= delta;
-			}
+	// Create the window and start the render thread with the renderer, fonts and textures. Sized after the entity stores
+	if (!initRender(pacing->mode == PRESENT_VSYNC, display))
+		success = false;
 
-			index--;
-		}
-	}
+	// Return bool indicating the success of initailizing everything
+	return success;
 }
 
-// Function for creating a new bullet
-void createBullet(int px, int py, int dir)
+// Parts of the program in the order they are torn down. Each one only frees what it owns and copes with never having been
+// initialized, so the same order works after a failed init
+typedef struct ShutdownStep
 {
-	int w_offset = 0, h_offset = 0;
-
-	if (dir == -1) {
-		w_offset = PLAYER_WIDTH / 2;
-		h_offset = PLAYER_HEIGHT / 2;
-	}
-	else if (dir == 1) {
-		w_offset = ENEMY_WIDTH / 2;
-		h_offset = ENEMY_HEIGHT / 2;
-	}
-
-	for (unsigned int i = 0; i < MAX_PROJECTILES; i++)
-	{
-		if (bullets[i] == NULL)
-		{
-			bullets[i] = (Bullet*)malloc(sizeof(Bullet));
-
-			if (bullets[i])
-			{
-				bullets[i]->px = (float)px + w_offset;
-				bullets[i]->py = (float)py + h_offset;
-				bullets[i]->vy = dir;
-			}
-
-			break;
-		}
-	}
-}
-
-// Function for updating all bullets
-void updateBullets(float delta)
+	const char* name;
+	void (*quit)(void);
+} ShutdownStep;
+
+static const ShutdownStep shutdownSteps[] = {
+	{ "session", finishSession }, // Reads the world and the profiler, before anything is freed
+	{ "netplay", quitNetplay }, // Tells the other side before anything else goes, and frees its snapshots of the world
+	{ "render", quitRender }, // Joins the render thread, which reads the draw queue and the sprites
+	{ "input", quitInput },
+	{ "pacing", quitPacing },
+	{ "audio", quitAudio }, // Packed sounds are played straight from the pack
+	{ "scores", quitScores }, // Writes the table if it changed since the last write
+	{ "telemetry", quitTelemetry },
+	{ "worlds", freeWorlds },
+	{ "assets", freeAssets },
+	{ "SDL", SDL_Quit },
+};
+
+#define SHUTDOWN_STEP_COUNT (int)(sizeof shutdownSteps / sizeof shutdownSteps[0])
+
+// Function that gets called when the program exits, it tears everything down once and reports slow shutdowns
+void exitProgram(void)
 {
-	for (unsigned int i = 0; i < MAX_PROJECTILES; i++)
-	{
-		if (bullets[i] != NULL)
-		{
-			bullets[i]->py += (float)bullets[i]->vy * (float)BULLET_SPEED * delta;
+	if (exited)
+		return;
+	exited = true;
 
-			if (bullets[i]->py < 0 || bullets[i]->py > WINDOW_HEIGHT - BULLET_HEIGHT)
-			{
-				Particle particle = {
-					.px = bullets[i]->px,
-					.py = bullets[i]->py,
-					.lifetime = 0.5f,
-					.particleType = BULLET_EXPLOSION,
-				};
-
-				createParticle(particle);
-
-				free(bullets[i]);
-				bullets[i] = NULL;
-				
-				Mix_PlayChannel(-1, hit_sound, 0);
-			}
-		}
-	}
-}
+	Uint64 frequency = SDL_GetPerformanceFrequency();
+	double times[SHUTDOWN_STEP_COUNT];
+	double total = 0.0;
+	int slowest = 0;
 
-// Function for creating a new particle
-void createParticle(Particle particle) 
-{
-	// Find an unused spot in the particles pointer, allocate memory and assign new value to the particle in question
-	for (unsigned int i = 0; i < MAX_PARTICLES; i++)
+	for (int n = 0; n < SHUTDOWN_STEP_COUNT; n++)
 	{
-		if (particles[i] == NULL)
-		{
-			particles[i] = (Particle*)malloc(sizeof(Particle));
+		Uint64 start = SDL_GetPerformanceCounter();
+		shutdownSteps[n].quit();
 
-			if (particles[i])
-			{
-				particles[i]->px = particle.px;
-				particles[i]->py = particle.py;
-				particles[i]->lifetime = particle.lifetime;
-				particles[i]->particleType = particle.particleType;
-			}
+		times[n] = (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / (double)frequency;
+		total += times[n];
 
-			break;
-		}
+		if (times[n] > times[slowest])
+			slowest = n;
 	}
-}
-
-// Function for updating particles
-void updateParticles(float delta) 
-{
-	// Loop through all existing particles, check if they should be destroyed and decrement their lifetime counter
-	for (unsigned int i = 0; i < MAX_PARTICLES; i++)
-	{
-		if (particles[i] != NULL && particles[i])
-		{
-			particles[i]->lifetime -= delta;
-
-			if(particles[i]->lifetime <= 0) 
-			{
-				free(particles[i]);
-				particles[i] = NULL;
-			}
-		}
-	}
-}
-
-// Function for cheking bullet collisions
-void checkBulletCollisions(Player* player)
-{
-	SDL_Rect playerRect = {
-		.x = (int)player->px,
-		.y = (int)player->py,
-		.w = PLAYER_WIDTH,
-		.h = PLAYER_HEIGHT
-	};
-
-	for (unsigned int i = 0; i < MAX_PROJECTILES; i++)
-	{
-		if (bullets[i] != NULL)
-		{
-			SDL_Rect bulletRect = {
-				.x = (int)bullets[i]->px,
-				.y = (int)bullets[i]->py,
-				.w = BULLET_WIDTH,
-				.h = BULLET_HEIGHT
-			};
-
-			for (unsigned int j = 0; j < MAX_ENEMIES; j++)
-			{
-				if (enemies[j] != NULL)
-				{
-					SDL_Rect enemyRect = {
-					.x = (int)enemies[j]->px,
-					.y = (int)enemies[j]->py,
-					.w = ENEMY_WIDTH,
-					.h = ENEMY_HEIGHT
-					};
-
-					if (bullets[i])
-					{
-						if (SDL_HasIntersection(&bulletRect, &enemyRect) && bullets[i]->vy != 1)
-						{
-							SDL_Log("Enemy hit");
-							Mix_PlayChannel(-1, hit_sound, 0);
-
-							player->score += enemies[j]->killReward;
-
-							Particle particle = {
-								.px = (float)enemyRect.x,
-								.py = (float)enemyRect.y,
-								.lifetime = 0.5f,
-								.particleType = SHIP_EXPLOSION,
-							};
-
-							createParticle(particle);
-
-							ENEMY_SPEED_OFFSET += ENEMY_SPEED_OFFSET_INCR;
-
-							free(enemies[j]);
-							enemies[j] = NULL;
-
-							free(bullets[i]);
-							bullets[i] = NULL;
-						}
-					}
-				}
-			}
-
-			if (bullets[i])
-			{
-				if (SDL_HasIntersection(&bulletRect, &playerRect) && bullets[i]->vy != -1)
-				{
-					Particle particle = {
-						.px = bullets[i]->px,
-						.py = bullets[i]->py,
-						.lifetime = 0.5f,
-						.particleType = SHIP_EXPLOSION,
-					};
 
-					createParticle(particle);
+#ifdef _DEBUG
+	for (int n = 0; n < SHUTDOWN_STEP_COUNT; n++)
+		printf("Shutdown %s: %.3f ms\n", shutdownSteps[n].name, times[n]);
 
-					free(bullets[i]);
-					bullets[i] = NULL;
+	// Everything SDL and its libraries allocated should be gone with them
+	int leaked = SDL_GetNumAllocations();
+	if (leaked > 0)
+		printf("%d SDL allocations are still live after shutdown\n", leaked);
+#endif
 
-					Mix_PlayChannel(-1, hit_sound, 0);
-
-					player->livesLeft -= 1;
-
-					if (player->livesLeft <= 0)
-						gameOver = true;
-
-					player->px = WINDOW_WIDTH / 2;
-					player->py = WINDOW_HEIGHT - (WINDOW_HEIGHT / 14);
-				}
-			}
-		}
-	}
+	if (total > SLOW_SHUTDOWN_TIME)
+		printf("Shutdown took %.1f ms, %.1f ms of it in %s\n", total, times[slowest], shutdownSteps[slowest].name);
 }
 
-// Function for ending the game and spawning new waves
-void checkGameState(Player* player)
+// Function that finishes the recording and writes the profile and the stress results of the session
+void finishSession(void)
 {
-	// If game is over, set a new highscore, create a new player and create new enemies
-	if (gameOver)
-	{
-		int tempScore = player->hiScore;
-		if (player->score > player->hiScore)
-		{
-			tempScore = player->score;
-		}
-
-		createPlayer(player);
-		player->hiScore = tempScore;
-
-		freeEnemies();
-		freeBullets();
-
-		createEnemies();
+	// Finish the recording with the state it ended in
+	stopRecording(&recorder, hashGameState(&gameWorld));
+	freeReplay(&replay);
 
-		ENEMY_SPEED_OFFSET = BASE_ENEMY_SPEED_OFFSET;
+	if (profilerOptions.outputPath)
+		writeProfile(profilerOptions.outputPath);
 
-		gameOver = false;
-	}
-	
-	// If no more enemies exist, spawn a new wave
-	bool spawnNextWave = true;
-	for (unsigned int i = 0; i < MAX_ENEMIES; i++)
-		if (enemies[i] != NULL) { spawnNextWave = false; break; }
-
-	// Increment wave counter and spawn new enemies. Reset player lives to three.
-	if (spawnNextWave)
+	if (stressRun)
 	{
-		currentWave += 1;
-
-		freeEnemies();
-		createEnemies();
+		PhaseStats frame;
+		getPhaseStats(PHASE_FRAME, &frame);
 
-		player->livesLeft = 3;
-		ENEMY_SPEED_OFFSET = BASE_ENEMY_SPEED_OFFSET;
+		printf("Stress run: %d enemies, %d bullets, %d particles\n", gameWorld.enemies.capacity, gameWorld.bullets.capacity, gameWorld.particles.capacity);
+		printf("Frames: %llu, avg frame time %.3f ms, recent p99 %.3f ms\n", (unsigned long long)frame.calls,
+			frame.calls > 0 ? frame.total / (double)frame.calls / 1000.0 : 0.0, frame.p99 / 1000.0);
 	}
+	flushLog();
 }
 
-// Function for rendering the current stats on screen
-void renderStats(void)
+// Function that frees the world and the quick save
+void freeWorlds(void)
 {
-	SDL_Color color = { 255,255,255 };
-
-	// Create buffer for text
-	char buffer[20];
-
-	// Use snprintf to concatenate text and integers to a single buffer
-	snprintf(buffer, sizeof buffer, "%s%d", "Score: ", player.score);
-
-	drawText(buffer, game_font, color, 10, 15);
-
-	// The same thing continues on for the next lines...
-
-	snprintf(buffer, sizeof buffer, "%s%d", "High score: ", player.hiScore);
-
-	drawText(buffer, game_font, color, 10, 35);
-
-	snprintf(buffer, sizeof buffer, "%s%d", "Lives: ", player.livesLeft);
-
-	drawText(buffer, game_font, color, 520, 15);
-	
-	snprintf(buffer, sizeof buffer, "%s%d", "Wave: ", currentWave);
-
-	drawText(buffer, game_font, color, 520, 35);
+	freeSnapshot(&quickSave);
+	quitGame(&gameWorld);
 }
 
-// Function for rendering every type of entity in the game
-void renderEntities(void) 
+// Function that gets the input of the next tick from the replay, or from the input events once it has ended, and records it
+void readTickInput(PlayerInput* input, Uint64 tickEnd)
 {
-	// Set drawcolor to green
-	SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255);
-
-	// Create rectangle based on the player's coordinates and size
-	SDL_Rect player_rect = {
-		.x = (int)player.px,
-		.y = (int)player.py,
-		.w = PLAYER_WIDTH,
-		.h = PLAYER_HEIGHT
-	};
-
-	// Render given rectangle
-	SDL_RenderFillRect(renderer, &player_rect);
-
-	// Set drawcolor to white
-	SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-
-	// Base rect for enemy
-	SDL_Rect enemy_rect = {
-		.w = ENEMY_HEIGHT,
-		.h = ENEMY_WIDTH
-	};
-
-	for (unsigned int i = 0; i < MAX_ENEMIES; i++)
+	if (!nextReplayInput(&replay, input))
 	{
-		// If enemy exists...
-		if (enemies[i] != NULL)
+		// Print the result once, right when the replay ends
+		if (replay.finished && replay.data)
 		{
-			enemy_rect.x = (int)enemies[i]->px;
-			enemy_rect.y = (int)enemies[i]->py;
-
-			// Render the given enemy texture at the coordinates of the given rectangle
-			SDL_RenderCopy(renderer, enemy_tex, NULL, &enemy_rect);
+			checkReplayResult(&replay, hashGameState(&gameWorld));
+			freeReplay(&replay);
 		}
-	}
-
-	// Base rect for bullet
-	SDL_Rect bullet_rect = {
-	.w = BULLET_WIDTH,
-	.h = BULLET_HEIGHT
-	};
 
-	for (unsigned int i = 0; i < MAX_PROJECTILES; i++)
-	{
-		// If bullet exists...
-		if (bullets[i] != NULL)
-		{
-			// Add proper coordinates
-			bullet_rect.x = (int)bullets[i]->px,
-			bullet_rect.y = (int)bullets[i]->py,
-
-			// Render rectangle
-			SDL_RenderCopy(renderer, bullet_tex, NULL, &bullet_rect);
-		}
+		readInput(input, tickEnd);
 	}
 
-	// Base rect for particle
-	SDL_Rect particle_rect = {
-		.w = PARTICLE_WIDTH,
-		.h = PARTICLE_HEIGHT
-	};
-
-	for(unsigned int i = 0; i < MAX_PARTICLES; i++) 
-	{
-		if(particles[i] != NULL) 
-		{
-			particle_rect.x = (int)particles[i]->px;
-			particle_rect.y = (int)particles[i]->py;
-
-			SDL_RenderCopy(renderer, particle_textures[particles[i]->particleType], NULL, &particle_rect);
-		}
-	}
+	recordInput(&recorder, input);
 }
 
-// Helper function for drawing text
-void drawText(const char* text, TTF_Font* font, SDL_Color color, int px, int py)
+// Function that saves the state of the game. A recording, a replay or the other side of a session would stop matching the game, so it's not allowed during them
+void saveQuickState(void)
 {
-	// Create a surface and texture based on the arguments that have been passed in
-	SDL_Surface* textSurface = TTF_RenderText_Blended(font, text, color);
-	SDL_Texture* textTexture = SDL_CreateTextureFromSurface(renderer, textSurface);
-
-	// Get the size of the texture
-	int w, h;
-	SDL_QueryTexture(textTexture, NULL, NULL, &w, &h);
-
-	SDL_Rect textRect = { .x = px, .y = py, .w = w, .h = h };
-
-	// Render text to screen
-	SDL_RenderCopy(renderer, textTexture, NULL, &textRect);
-
-	// Free memory used by the surface and the texture
-	SDL_FreeSurface(textSurface);
-	SDL_DestroyTexture(textTexture);
+	if (recorder.file || replay.data || isNetplayActive())
+		return;
 
+	if (quickSave.memory)
+		saveSnapshot(&quickSave, &gameWorld);
+	else
+		createSnapshot(&quickSave, &gameWorld);
 }
 
-// Free memory used by enemies
-void freeEnemies(void) 
+// Function that loads the saved state of the game, if there is one
+void loadQuickState(void)
 {
-	for(unsigned int i = 0; i < MAX_ENEMIES; i++) 
-	{
-		free(enemies[i]);
-		enemies[i] = NULL;
-	}
-}
+	if (recorder.file || replay.data || isNetplayActive() || !quickSave.memory)
+		return;
 
-// Free memory used by bullets
-void freeBullets(void) 
-{
-	for (unsigned int i = 0; i < MAX_PROJECTILES; i++)
-	{
-		free(bullets[i]);
-		bullets[i] = NULL;
-	}
-}
-	
-// Free memory used by particles
-void freeParticles(void) 
-{
-	for (unsigned int i = 0; i < MAX_PARTICLES; i++)
-	{
-		free(particles[i]);
-		particles[i] = NULL;
-	}
+	restoreSnapshot(&gameWorld, &quickSave);
 }
 
-void renderMenu(void) 
-{
-	// Title
-	SDL_Color white = { 255,255,255 };
-	drawText("SPACE INVADERS", menu_font, white, WINDOW_WIDTH / 2 - 270, 35);
-
-	// Draw button text
-	drawText("Press space to play", menu_font, white, WINDOW_WIDTH / 2 - 290, WINDOW_HEIGHT / 2 - 35);	
-}
-
-void checkGameStart(void) 
-{
-	const Uint8* state = SDL_GetKeyboardState(NULL);
-
-	if(state[SDL_SCANCODE_SPACE]) 
-	{
-		playGame = true;
-		SDL_Delay(500);
-	}
-}
+#endif
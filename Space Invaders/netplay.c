@@ -0,0 +1,864 @@
+// Sockets and name lookups are POSIX, not part of C17
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200112L
+#endif
+
+#include "netplay.h"
+
+// Game modules
+#include "bytes.h"
+#include "replay.h"
+#include "tunables.h"
+
+// Standard libraries
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+
+typedef SOCKET NetSocket;
+#define INVALID_NET_SOCKET INVALID_SOCKET
+#define closeNetSocket closesocket
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+typedef int NetSocket;
+#define INVALID_NET_SOCKET (-1)
+#define closeNetSocket close
+#endif
+
+// Packets start with "SI", the version and the type, integers are little-endian:
+//   hello:   role (u8), hash of the tunables (u32), packed config, sent by a joining player or a spectator until it's welcomed
+//   welcome: seed (u32), state hash of the fresh world (u32), hash of the tunables (u32), packed config
+//   refuse:  reason (u8), the session already has a second player, every spectator slot is taken, or the tunables or the config differ
+//   inputs:  first tick (u32), ticks of the receiver's inputs the sender has (u32), count (u8), a packed input per tick
+//   stream:  first tick (u32), count (u16), the inputs of both players per tick, the host's in the low bits
+//   ack:     ticks of the stream the spectator has (u32)
+//   bye:     the sender is leaving
+#define NET_MAGIC_0 'S'
+#define NET_MAGIC_1 'I'
+#define NET_VERSION 2
+#define NET_HEADER_SIZE 4
+#define HELLO_SIZE (5 + PACKED_CONFIG_SIZE)
+#define WELCOME_SIZE (12 + PACKED_CONFIG_SIZE)
+#define NET_PACKET_SIZE 1200
+
+// Most inputs in a packet. Players resend every input the other hasn't confirmed, spectators get the stream in chunks
+#define MAX_PACKET_INPUTS 255
+#define MAX_STREAM_CHUNK 1024
+
+// Inputs of both players kept by tick, for resending and for simulating rolled back ticks again
+#define INPUT_HISTORY 256
+#define INPUT_MASK (INPUT_HISTORY - 1)
+
+// How long a joining player or spectator waits to be welcomed, and the host for its partner, in milliseconds
+#define NET_JOIN_WAIT 10000
+#define NET_HOST_WAIT 120000
+#define NET_HELLO_INTERVAL 250
+
+// Spectators further behind than this catch up with several ticks per call, at most this many
+#define SPECTATOR_LAG (TICK_RATE / 4)
+#define SPECTATOR_CATCH_UP 64
+
+#pragma region Structs and ENUMs
+
+typedef enum PacketType { PACKET_HELLO, PACKET_WELCOME, PACKET_REFUSE, PACKET_INPUTS, PACKET_STREAM, PACKET_ACK, PACKET_BYE } PacketType;
+
+typedef enum RefuseReason { REFUSE_FULL, REFUSE_TUNABLES, REFUSE_CONFIG } RefuseReason;
+
+// Spectator of the host, sent the stream from the first tick it hasn't confirmed
+typedef struct Spectator
+{
+	struct sockaddr_in address;
+	Uint32 next;
+	Uint64 lastHeard;
+} Spectator;
+
+#pragma endregion
+
+#pragma region Globals
+
+static NetRole role = NET_OFF;
+static NetSocket netSocket = INVALID_NET_SOCKET;
+
+// The host for joining players and spectators, the partner for the host once it has joined
+static struct sockaddr_in peer;
+static bool peerKnown = false;
+static bool peerLost = false;
+static Uint64 peerHeard = 0;
+
+// Seed, fresh world hash, tunables and config of the session, set by the host and checked by everyone else
+static Uint32 sessionSeed = 0;
+static Uint32 sessionHash = 0;
+static Uint32 sessionTunables = 0;
+static Uint8 sessionConfig[PACKED_CONFIG_SIZE];
+static bool welcomed = false;
+
+// Players: the next tick to simulate, the ticks of the other player's inputs received so far, and the ticks of ours it has
+static Uint32 simTick = 0;
+static Uint32 remoteTick = 0;
+static Uint32 remoteAck = 0;
+
+// Packed inputs by tick. The other player's input that each tick was simulated with is kept, to find the ticks that were predicted wrong
+static Uint8 localInputs[INPUT_HISTORY];
+static Uint8 remoteInputs[INPUT_HISTORY];
+static Uint8 usedInputs[INPUT_HISTORY];
+
+// State before each of the last ticks, by tick
+static WorldSnapshot snapshots[ROLLBACK_WINDOW];
+
+// Confirmed inputs of both players from the first tick, written by the host and read back by spectators. Late spectators start from the beginning
+static Uint8* stream = NULL;
+static Uint32 streamSize = 0, streamCapacity = 0;
+
+static Spectator spectators[MAX_SPECTATORS];
+static int spectatorCount = 0;
+
+static Uint64 frequency = 0;
+static Uint16 hostPort = 0;
+
+#pragma endregion
+
+#pragma region Helpers
+
+// Helper function for comparing two addresses
+static bool isSameAddress(const struct sockaddr_in* a, const struct sockaddr_in* b)
+{
+	return a->sin_addr.s_addr == b->sin_addr.s_addr && a->sin_port == b->sin_port;
+}
+
+// Helper function that tells whether a config packs the same as the one of the session
+static bool isSessionConfig(const GameConfig* config)
+{
+	Uint8 packed[PACKED_CONFIG_SIZE];
+	packGameConfig(config, packed);
+
+	return memcmp(packed, sessionConfig, PACKED_CONFIG_SIZE) == 0;
+}
+
+// Helper function for sending a packet with the header in front of the given body
+static void sendPacket(const struct sockaddr_in* address, PacketType type, const Uint8* body, int size)
+{
+	Uint8 packet[NET_PACKET_SIZE];
+
+	packet[0] = NET_MAGIC_0;
+	packet[1] = NET_MAGIC_1;
+	packet[2] = NET_VERSION;
+	packet[3] = (Uint8)type;
+
+	// Refusals and goodbyes have no body
+	if (size > 0)
+		memcpy(packet + NET_HEADER_SIZE, body, size);
+
+	sendto(netSocket, (const char*)packet, NET_HEADER_SIZE + size, 0, (const struct sockaddr*)address, sizeof *address);
+}
+
+// Helper function that resolves "HOST[:PORT]" to an IPv4 address
+static bool resolveAddress(const char* text, Uint16 port, struct sockaddr_in* address)
+{
+	char host[256];
+	SDL_strlcpy(host, text, sizeof host);
+
+	char* colon = strrchr(host, ':');
+	if (colon)
+	{
+		*colon = '\0';
+		port = (Uint16)atoi(colon + 1);
+	}
+
+	struct addrinfo hints = { .ai_family = AF_INET, .ai_socktype = SOCK_DGRAM };
+	struct addrinfo* found = NULL;
+
+	if (getaddrinfo(host, NULL, &hints, &found) != 0 || !found)
+	{
+		printf("Couldn't find the host %s\n", host);
+		return false;
+	}
+
+	*address = *(const struct sockaddr_in*)found->ai_addr;
+	address->sin_port = htons(port);
+	freeaddrinfo(found);
+
+	return true;
+}
+
+// Helper function for adding the confirmed inputs of a tick to the stream
+static bool appendStream(Uint8 inputs)
+{
+	if (streamSize == streamCapacity)
+	{
+		Uint32 capacity = streamCapacity ? streamCapacity * 2 : 60 * TICK_RATE;
+		Uint8* grown = (Uint8*)realloc(stream, capacity);
+
+		if (!grown)
+			return false;
+
+		stream = grown;
+		streamCapacity = capacity;
+	}
+
+	stream[streamSize++] = inputs;
+	return true;
+}
+
+// Helper function for getting the packed inputs of both players for a tick, the host's first
+static Uint8 getTickInputs(Uint32 tick)
+{
+	Uint8 local = localInputs[tick & INPUT_MASK], remote = usedInputs[tick & INPUT_MASK];
+	return role == NET_HOST ? (Uint8)(local | (remote << INPUT_BITS)) : (Uint8)(remote | (local << INPUT_BITS));
+}
+
+// Function that runs a tick with the inputs of both players
+static void simulateTick(World* world, Uint8 inputs)
+{
+	PlayerInput input[MAX_PLAYERS];
+	unpackInput(inputs & ((1 << INPUT_BITS) - 1), &input[0]);
+	unpackInput(inputs >> INPUT_BITS, &input[1]);
+
+	update(world, input, (float)TICK_TIME);
+}
+
+// Function for getting the input of the other player for a tick, the last one received stands in for the ones that haven't arrived
+static Uint8 getRemoteInput(Uint32 tick)
+{
+	if (tick < remoteTick)
+		return remoteInputs[tick & INPUT_MASK];
+
+	return remoteTick > 0 ? remoteInputs[(remoteTick - 1) & INPUT_MASK] : 0;
+}
+
+// Function that goes back to the state before a tick and simulates every tick since again with the inputs known now.
+// The sounds, the counters and the finished game the main loop takes from the world were already produced once, so they are kept as they were
+static void rollBack(World* world, Uint32 tick)
+{
+	Uint32 sounds = world->sounds;
+	Uint32 shotsFired = world->shotsFired, enemiesKilled = world->enemiesKilled;
+	bool gameFinished = world->gameFinished;
+	GameResult lastGame = world->lastGame;
+
+	restoreSnapshot(world, &snapshots[tick % ROLLBACK_WINDOW]);
+
+	for (Uint32 t = tick; t < simTick; t++)
+	{
+		if (t != tick)
+			saveSnapshot(&snapshots[t % ROLLBACK_WINDOW], world);
+
+		usedInputs[t & INPUT_MASK] = getRemoteInput(t);
+		simulateTick(world, getTickInputs(t));
+	}
+
+	world->sounds = sounds;
+	world->shotsFired = shotsFired;
+	world->enemiesKilled = enemiesKilled;
+	world->gameFinished = gameFinished;
+	world->lastGame = lastGame;
+}
+
+// Function that adds every tick both players agree on to the stream of the host, once it has been simulated with the inputs of both
+static void extendStream(void)
+{
+	Uint32 confirmed = min(simTick, remoteTick);
+
+	while (role == NET_HOST && streamSize < confirmed)
+	{
+		if (!appendStream(getTickInputs(streamSize)))
+			break;
+	}
+}
+
+#pragma endregion
+
+#pragma region Packets
+
+// Helper function for refusing a hello, a refusal for a different game says so on the host as well
+static void refuseHello(const struct sockaddr_in* from, RefuseReason reason)
+{
+	Uint8 body[1] = { (Uint8)reason };
+	sendPacket(from, PACKET_REFUSE, body, sizeof body);
+
+	if (reason != REFUSE_FULL)
+	{
+		char name[INET_ADDRSTRLEN] = "";
+		inet_ntop(AF_INET, &from->sin_addr, name, sizeof name);
+		printf("Refused %s:%d, it plays with other %s\n", name, ntohs(from->sin_port), reason == REFUSE_TUNABLES ? "tunables" : "options");
+	}
+}
+
+// Function that answers a hello. The host takes the first player that asks as its partner and any number of spectators up to the limit
+static void handleHello(const struct sockaddr_in* from, const Uint8* body, int size)
+{
+	if (role != NET_HOST || size < HELLO_SIZE)
+		return;
+
+	// Everyone has to build the same world and simulate it with the same values, anything else would desync from the first tick
+	if ((Uint32)readLittleEndian(body + 1, 4) != sessionTunables)
+	{
+		refuseHello(from, REFUSE_TUNABLES);
+		return;
+	}
+
+	if (memcmp(body + 5, sessionConfig, PACKED_CONFIG_SIZE) != 0)
+	{
+		refuseHello(from, REFUSE_CONFIG);
+		return;
+	}
+
+	Uint8 welcome[WELCOME_SIZE];
+	writeLittleEndian(welcome, sessionSeed, 4);
+	writeLittleEndian(welcome + 4, sessionHash, 4);
+	writeLittleEndian(welcome + 8, sessionTunables, 4);
+	memcpy(welcome + 12, sessionConfig, PACKED_CONFIG_SIZE);
+
+	if (body[0] == NET_JOIN)
+	{
+		if (peerKnown && !isSameAddress(from, &peer))
+		{
+			refuseHello(from, REFUSE_FULL);
+			return;
+		}
+
+		if (!peerKnown)
+		{
+			char name[INET_ADDRSTRLEN] = "";
+			inet_ntop(AF_INET, &from->sin_addr, name, sizeof name);
+			printf("A player joined from %s:%d\n", name, ntohs(from->sin_port));
+		}
+
+		peer = *from;
+		peerKnown = true;
+		peerHeard = SDL_GetPerformanceCounter();
+		sendPacket(from, PACKET_WELCOME, welcome, sizeof welcome);
+		return;
+	}
+
+	// Spectators that ask again were already added
+	for (int n = 0; n < spectatorCount; n++)
+	{
+		if (isSameAddress(from, &spectators[n].address))
+		{
+			sendPacket(from, PACKET_WELCOME, welcome, sizeof welcome);
+			return;
+		}
+	}
+
+	if (spectatorCount == MAX_SPECTATORS)
+	{
+		refuseHello(from, REFUSE_FULL);
+		return;
+	}
+
+	spectators[spectatorCount++] = (Spectator){ .address = *from, .next = 0, .lastHeard = SDL_GetPerformanceCounter() };
+	sendPacket(from, PACKET_WELCOME, welcome, sizeof welcome);
+}
+
+// Function that takes the inputs of the other player, and finds the earliest tick that was simulated with a wrong guess. Returns simTick if there is none
+static Uint32 handleInputs(const Uint8* body, int size)
+{
+	Uint32 rollback = simTick;
+
+	if (size < 9)
+		return rollback;
+
+	Uint32 first = (Uint32)readLittleEndian(body, 4);
+	Uint32 ack = (Uint32)readLittleEndian(body + 4, 4);
+	int count = body[8];
+
+	if (size < 9 + count)
+		return rollback;
+
+	// Acks only move forward, late packets carry old ones
+	if (ack > remoteAck)
+		remoteAck = ack;
+
+	// Inputs are taken in order, a packet that starts past a gap is covered again by the next one
+	for (int n = 0; n < count; n++)
+	{
+		Uint32 tick = first + (Uint32)n;
+		if (tick != remoteTick)
+			continue;
+
+		Uint8 input = body[9 + n];
+		remoteInputs[tick & INPUT_MASK] = input;
+		remoteTick++;
+
+		if (tick < simTick && input != usedInputs[tick & INPUT_MASK] && tick < rollback)
+			rollback = tick;
+	}
+
+	// A tick predicted wrong also makes every later guess wrong, they are all simulated again from the first one
+	return rollback;
+}
+
+// Function that adds the stream a spectator was sent to what it has
+static void handleStream(const Uint8* body, int size)
+{
+	if (size < 6)
+		return;
+
+	Uint32 first = (Uint32)readLittleEndian(body, 4);
+	int count = (int)readLittleEndian(body + 4, 2);
+
+	for (int n = 0; n < count && 6 + n < size; n++)
+	{
+		if (first + (Uint32)n == streamSize)
+			appendStream(body[6 + n]);
+	}
+}
+
+// Function that moves a spectator on to the ticks it hasn't got yet
+static void handleAck(const struct sockaddr_in* from, const Uint8* body, int size)
+{
+	if (size < 4)
+		return;
+
+	Uint32 next = (Uint32)readLittleEndian(body, 4);
+
+	for (int n = 0; n < spectatorCount; n++)
+	{
+		if (isSameAddress(from, &spectators[n].address))
+		{
+			spectators[n].next = max(spectators[n].next, next);
+			spectators[n].lastHeard = SDL_GetPerformanceCounter();
+		}
+	}
+}
+
+// Helper function for removing a spectator, the last one takes its place
+static void removeSpectator(int index)
+{
+	spectators[index] = spectators[--spectatorCount];
+}
+
+// Function that reads every packet that arrived. Returns the earliest tick that has to be simulated again for players, simTick if none
+static Uint32 receivePackets(void)
+{
+	Uint32 rollback = simTick;
+	Uint8 packet[NET_PACKET_SIZE];
+
+	for (;;)
+	{
+		struct sockaddr_in from;
+		socklen_t fromSize = sizeof from;
+
+		int size = (int)recvfrom(netSocket, (char*)packet, sizeof packet, 0, (struct sockaddr*)&from, &fromSize);
+		if (size < 0)
+			break;
+
+		if (size < NET_HEADER_SIZE || packet[0] != NET_MAGIC_0 || packet[1] != NET_MAGIC_1 || packet[2] != NET_VERSION)
+			continue;
+
+		PacketType type = (PacketType)packet[3];
+		const Uint8* body = packet + NET_HEADER_SIZE;
+		size -= NET_HEADER_SIZE;
+
+		if (type == PACKET_HELLO)
+		{
+			handleHello(&from, body, size);
+			continue;
+		}
+
+		if (type == PACKET_ACK && role == NET_HOST)
+		{
+			handleAck(&from, body, size);
+			continue;
+		}
+
+		if (type == PACKET_BYE && role == NET_HOST)
+		{
+			for (int n = spectatorCount - 1; n >= 0; n--)
+			{
+				if (isSameAddress(&from, &spectators[n].address))
+					removeSpectator(n);
+			}
+		}
+
+		// Everything else only counts from the other side of the session
+		if (!peerKnown || !isSameAddress(&from, &peer))
+			continue;
+
+		peerHeard = SDL_GetPerformanceCounter();
+
+		switch (type)
+		{
+		case PACKET_WELCOME:
+			if (!welcomed && size >= WELCOME_SIZE)
+			{
+				sessionSeed = (Uint32)readLittleEndian(body, 4);
+				sessionHash = (Uint32)readLittleEndian(body + 4, 4);
+				sessionTunables = (Uint32)readLittleEndian(body + 8, 4);
+				memcpy(sessionConfig, body + 12, PACKED_CONFIG_SIZE);
+				welcomed = true;
+			}
+			break;
+		case PACKET_REFUSE:
+			if (size >= 1 && body[0] == REFUSE_TUNABLES)
+				printf("The host refused the connection, it plays with other tunables\n");
+			else if (size >= 1 && body[0] == REFUSE_CONFIG)
+				printf("The host refused the connection, start with the same options as the host\n");
+			else
+				printf("The host refused the connection, it already has a second player or is full\n");
+
+			peerLost = true;
+			break;
+		case PACKET_INPUTS:
+			if (role == NET_HOST || role == NET_JOIN)
+			{
+				// Not inside min, which would read the packet twice
+				Uint32 wrong = handleInputs(body, size);
+				rollback = min(rollback, wrong);
+			}
+			break;
+		case PACKET_STREAM:
+			if (role == NET_WATCH)
+				handleStream(body, size);
+			break;
+		case PACKET_BYE:
+			printf(role == NET_WATCH ? "The host ended the session\n" : "The other player left, their ship stays idle\n");
+			peerLost = true;
+			break;
+		default:
+			break;
+		}
+	}
+
+	return rollback;
+}
+
+#pragma endregion
+
+// Function that parses "--host [PORT]", "--join HOST[:PORT]" and "--watch HOST[:PORT]"
+void parseNetOptions(int argc, char* argv[], NetOptions* options)
+{
+	options->role = NET_OFF;
+	options->address = NULL;
+	options->port = DEFAULT_NET_PORT;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--host") == 0)
+		{
+			options->role = NET_HOST;
+
+			if (i + 1 < argc && atoi(argv[i + 1]) > 0)
+				options->port = (Uint16)atoi(argv[++i]);
+		}
+		else if ((strcmp(argv[i], "--join") == 0 || strcmp(argv[i], "--watch") == 0) && i + 1 < argc)
+		{
+			options->role = strcmp(argv[i], "--join") == 0 ? NET_JOIN : NET_WATCH;
+			options->address = argv[++i];
+		}
+	}
+}
+
+// Function that opens the socket, and for joining players and spectators asks the host into the session
+bool initNetplay(const NetOptions* options, const GameConfig* config, unsigned int* seed)
+{
+	role = options->role;
+	if (role == NET_OFF)
+		return true;
+
+	frequency = SDL_GetPerformanceFrequency();
+
+#ifdef _WIN32
+	WSADATA data;
+	if (WSAStartup(MAKEWORD(2, 2), &data) != 0)
+	{
+		printf("Couldn't start Winsock\n");
+		role = NET_OFF;
+		return false;
+	}
+#endif
+
+	netSocket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	if (netSocket == INVALID_NET_SOCKET)
+	{
+		printf("Couldn't open a UDP socket\n");
+		quitNetplay();
+		return false;
+	}
+
+	// The game never waits on the socket, packets are read between ticks
+#ifdef _WIN32
+	u_long nonBlocking = 1;
+	ioctlsocket(netSocket, FIONBIO, &nonBlocking);
+#else
+	fcntl(netSocket, F_SETFL, fcntl(netSocket, F_GETFL, 0) | O_NONBLOCK);
+#endif
+
+	if (role == NET_HOST)
+	{
+		struct sockaddr_in address = { .sin_family = AF_INET, .sin_port = htons(options->port), .sin_addr.s_addr = htonl(INADDR_ANY) };
+
+		if (bind(netSocket, (const struct sockaddr*)&address, sizeof address) != 0)
+		{
+			printf("Couldn't listen on port %d\n", options->port);
+			quitNetplay();
+			return false;
+		}
+
+		// The seed the host picked is the seed of the session
+		sessionSeed = *seed;
+		hostPort = options->port;
+		return true;
+	}
+
+	if (!resolveAddress(options->address, options->port, &peer))
+	{
+		quitNetplay();
+		return false;
+	}
+
+	peerKnown = true;
+
+	Uint8 hello[HELLO_SIZE];
+	hello[0] = (Uint8)role;
+	writeLittleEndian(hello + 1, hashTunables(), 4);
+	packGameConfig(config, hello + 5);
+	Uint32 start = SDL_GetTicks();
+
+	while (!welcomed && !peerLost && SDL_GetTicks() - start < NET_JOIN_WAIT)
+	{
+		sendPacket(&peer, PACKET_HELLO, hello, sizeof hello);
+		SDL_Delay(NET_HELLO_INTERVAL);
+		receivePackets();
+	}
+
+	if (!welcomed)
+	{
+		if (!peerLost)
+			printf("No answer from %s\n", options->address);
+
+		quitNetplay();
+		return false;
+	}
+
+	*seed = sessionSeed;
+	return true;
+}
+
+// Function that starts the session on a created world
+bool startNetplay(World* world)
+{
+	if (role == NET_OFF)
+		return true;
+
+	// Playing peers roll back, spectators only ever play confirmed inputs
+	for (int n = 0; n < ROLLBACK_WINDOW && role != NET_WATCH; n++)
+	{
+		if (!createSnapshot(&snapshots[n], world))
+			return false;
+	}
+
+	if (role == NET_HOST)
+	{
+		sessionHash = hashGameState(world);
+		sessionTunables = hashTunables();
+		packGameConfig(&world->config, sessionConfig);
+		printf("Waiting for a player to join on port %d\n", hostPort);
+
+		Uint32 start = SDL_GetTicks();
+		while (!peerKnown && SDL_GetTicks() - start < NET_HOST_WAIT)
+		{
+			SDL_Delay(10);
+			receivePackets();
+		}
+
+		if (!peerKnown)
+		{
+			printf("Nobody joined\n");
+			return false;
+		}
+	}
+	else if (hashTunables() != sessionTunables)
+	{
+		// Tunables aren't part of the world, a dev build with an edited file would simulate differently from the same world
+		printf("The host plays with other tunables (hash %08x, these are %08x), start with the same values as the host\n", sessionTunables, hashTunables());
+		return false;
+	}
+	else if (!isSessionConfig(&world->config))
+	{
+		printf("The host plays with other options, start with the same options and waves as the host\n");
+		return false;
+	}
+	else if (hashGameState(world) != sessionHash)
+	{
+		printf("The world doesn't match the host's, start with the same options as the host\n");
+		return false;
+	}
+
+	peerHeard = SDL_GetPerformanceCounter();
+	return true;
+}
+
+// Function that says goodbye and closes the socket
+void quitNetplay(void)
+{
+	if (netSocket != INVALID_NET_SOCKET)
+	{
+		if (peerKnown && !peerLost)
+			sendPacket(&peer, PACKET_BYE, NULL, 0);
+
+		for (int n = 0; n < spectatorCount; n++)
+			sendPacket(&spectators[n].address, PACKET_BYE, NULL, 0);
+
+		closeNetSocket(netSocket);
+		netSocket = INVALID_NET_SOCKET;
+	}
+
+#ifdef _WIN32
+	if (role != NET_OFF)
+		WSACleanup();
+#endif
+
+	for (int n = 0; n < ROLLBACK_WINDOW; n++)
+		freeSnapshot(&snapshots[n]);
+
+	free(stream);
+	stream = NULL;
+	streamSize = streamCapacity = 0;
+
+	spectatorCount = 0;
+	simTick = remoteTick = remoteAck = 0;
+	peerKnown = peerLost = welcomed = false;
+	role = NET_OFF;
+}
+
+// Function that tells whether a session drives the world
+bool isNetplayActive(void)
+{
+	return role != NET_OFF;
+}
+
+// Function that runs the next tick of the session
+bool readyForNetplayTick(World* world)
+{
+	Uint32 rollback = receivePackets();
+
+	if (role == NET_WATCH)
+		return streamSize > simTick;
+
+	if (rollback < simTick)
+		rollBack(world, rollback);
+
+	// Once the other player is gone, its ship gets no input from the first tick that wasn't received on
+	if (peerLost)
+	{
+		for (; remoteTick < simTick; remoteTick++)
+			remoteInputs[remoteTick & INPUT_MASK] = usedInputs[remoteTick & INPUT_MASK];
+
+		remoteInputs[simTick & INPUT_MASK] = 0;
+		remoteTick = simTick + 1;
+	}
+
+	// Inputs that came in confirm ticks even when no new tick can run
+	extendStream();
+
+	// Wait for the other player rather than guess further than a snapshot reaches back
+	return simTick < remoteTick + ROLLBACK_WINDOW;
+}
+
+// Function that runs the next tick of the session
+bool advanceNetplay(World* world, const PlayerInput* local)
+{
+	if (role == NET_WATCH)
+	{
+		// Play at the pace of the stream, and catch up quickly when joining late or after a stall
+		Uint32 available = streamSize - simTick;
+		Uint32 ticks = available > SPECTATOR_LAG ? min(available, SPECTATOR_CATCH_UP) : min(available, 1u);
+
+		for (Uint32 n = 0; n < ticks; n++)
+			simulateTick(world, stream[simTick++]);
+
+		return ticks > 0;
+	}
+
+	if (simTick >= remoteTick + ROLLBACK_WINDOW)
+		return false;
+
+	localInputs[simTick & INPUT_MASK] = packInput(local);
+	usedInputs[simTick & INPUT_MASK] = getRemoteInput(simTick);
+
+	saveSnapshot(&snapshots[simTick % ROLLBACK_WINDOW], world);
+	simulateTick(world, getTickInputs(simTick));
+	simTick++;
+
+	extendStream();
+	return true;
+}
+
+// Function that sends what the other side is missing, and drops whoever stopped answering
+void flushNetplay(void)
+{
+	if (role == NET_OFF)
+		return;
+
+	Uint64 now = SDL_GetPerformanceCounter();
+	Uint64 timeout = frequency * NET_TIMEOUT;
+
+	if (!peerLost && peerKnown && now - peerHeard > timeout)
+	{
+		printf(role == NET_WATCH ? "The host stopped answering\n" : "The other player stopped answering, their ship stays idle\n");
+		peerLost = true;
+	}
+
+	Uint8 body[NET_PACKET_SIZE - NET_HEADER_SIZE];
+
+	if (role == NET_WATCH)
+	{
+		if (!peerLost)
+		{
+			writeLittleEndian(body, streamSize, 4);
+			sendPacket(&peer, PACKET_ACK, body, 4);
+		}
+		return;
+	}
+
+	// Every input the other player hasn't confirmed, so a lost packet is covered by the next one
+	if (!peerLost && peerKnown)
+	{
+		Uint32 first = max(remoteAck, simTick > MAX_PACKET_INPUTS ? simTick - MAX_PACKET_INPUTS : 0);
+		Uint32 count = simTick > first ? simTick - first : 0;
+
+		writeLittleEndian(body, first, 4);
+		writeLittleEndian(body + 4, remoteTick, 4);
+		body[8] = (Uint8)count;
+
+		for (Uint32 n = 0; n < count; n++)
+			body[9 + n] = localInputs[(first + n) & INPUT_MASK];
+
+		sendPacket(&peer, PACKET_INPUTS, body, 9 + (int)count);
+	}
+
+	if (role != NET_HOST)
+		return;
+
+	for (int n = spectatorCount - 1; n >= 0; n--)
+	{
+		Spectator* spectator = &spectators[n];
+
+		if (now - spectator->lastHeard > timeout)
+		{
+			removeSpectator(n);
+			continue;
+		}
+
+		// The chunk from the first tick the spectator is missing, an empty one keeps a spectator that's caught up from timing out
+		Uint32 first = min(spectator->next, streamSize);
+		Uint32 count = min(streamSize - first, (Uint32)MAX_STREAM_CHUNK);
+
+		writeLittleEndian(body, first, 4);
+		writeLittleEndian(body + 4, count, 2);
+		if (count > 0)
+			memcpy(body + 6, stream + first, count);
+
+		sendPacket(&spectator->address, PACKET_STREAM, body, 6 + (int)count);
+	}
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+// SDL libraries
+#include <SDL.h>
+
+// Game modules
+#include "game.h"
+
+// Helper libraries
+#include <stdbool.h>
+
+#pragma region Structs and defines
+
+// Port of "--host" when none is given, and of "--join" and "--watch" addresses without one
+#define DEFAULT_NET_PORT 47230
+
+// Ticks a player may simulate past the last input it has from the other. Every one of them keeps a snapshot to roll back to
+#define ROLLBACK_WINDOW 32
+
+// Most spectators a host streams to
+#define MAX_SPECTATORS 256
+
+// Seconds without a packet before the other side counts as gone
+#define NET_TIMEOUT 5
+
+// How the game takes part in a session: playing it on the host, joining it as the second player, or watching it
+typedef enum NetRole { NET_OFF, NET_HOST, NET_JOIN, NET_WATCH } NetRole;
+
+// Session from "--host [PORT]", "--join HOST[:PORT]" or "--watch HOST[:PORT]"
+typedef struct NetOptions
+{
+	NetRole role;
+	const char* address; // Host to join or watch, NULL when hosting
+	Uint16 port;
+} NetOptions;
+
+#pragma endregion
+
+#pragma region Function declarations
+
+// Parse the session options from the command line
+void parseNetOptions(int argc, char* argv[], NetOptions* options);
+
+// Open the socket. Joining players and spectators get the seed of the session from the host here, before the world is created,
+// and are refused when their config or their tunables differ from the host's
+bool initNetplay(const NetOptions* options, const GameConfig* config, unsigned int* seed);
+
+// Start the session once the world is created. The host waits for its partner, the others check they built the same world as the host
+bool startNetplay(World* world);
+
+void quitNetplay(void);
+
+// Whether the world is driven by a session instead of by the local input alone
+bool isNetplayActive(void);
+
+// Take in what arrived and roll the world back when a predicted input turned out different. Returns false while the next tick has to wait,
+// for the other player or for the stream, so the local input of the tick isn't read before it can be used
+bool readyForNetplayTick(World* world);
+
+// Advance the world by one tick with the local input, once readyForNetplayTick allowed it. Players predict the input of the other player,
+// spectators play the inputs the host streams. Returns false when no tick could be run, the world is left as it was then
+bool advanceNetplay(World* world, const PlayerInput* local);
+
+// Send the inputs of the frame, once per frame after its ticks
+void flushNetplay(void);
+
+#pragma endregion
@@ -0,0 +1,167 @@
+#include "pacing.h"
+
+// Game modules
+#include "profiler.h"
+
+// Standard libraries
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+
+// Not defined by older Windows SDKs
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+#endif
+
+#pragma region Globals
+
+static const char* modeNames[PRESENT_MODE_COUNT] = { "vsync", "uncapped", "limited" };
+
+static PresentMode presentMode = PRESENT_VSYNC;
+
+// Length of a limited frame, and when the next one is due, in performance counter units
+static Uint64 framePeriod = 0;
+static Uint64 nextFrame = 0;
+
+// When the last frame was presented, 0 before the first one
+static Uint64 lastPresent = 0;
+
+#ifdef _WIN32
+// Sleeps with sub-millisecond precision, NULL on Windows versions without high resolution timers
+static HANDLE sleepTimer = NULL;
+#endif
+
+#pragma endregion
+
+// Function for getting the pacing options from the command line
+void parsePacingOptions(int argc, char* argv[], PacingOptions* options)
+{
+	options->mode = PRESENT_VSYNC;
+	options->fps = DEFAULT_FPS;
+
+	for (int i = 1; i < argc - 1; i++)
+	{
+		if (strcmp(argv[i], "--present") == 0)
+		{
+			const char* mode = argv[++i];
+
+			for (int m = 0; m < PRESENT_MODE_COUNT; m++)
+				if (strcmp(mode, modeNames[m]) == 0)
+					options->mode = (PresentMode)m;
+		}
+		else if (strcmp(argv[i], "--fps") == 0)
+		{
+			options->fps = atoi(argv[++i]);
+		}
+	}
+
+	if (options->fps < 1 || options->fps > 1000)
+		options->fps = DEFAULT_FPS;
+}
+
+// Function that sets up the limiter and the high resolution sleep timer
+bool initPacing(const PacingOptions* options)
+{
+	presentMode = options->mode;
+	framePeriod = SDL_GetPerformanceFrequency() / (Uint64)options->fps;
+	nextFrame = 0;
+	lastPresent = 0;
+
+#ifdef _WIN32
+	sleepTimer = CreateWaitableTimerExW(NULL, NULL, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+#endif
+
+	return true;
+}
+
+// Free the sleep timer
+void quitPacing(void)
+{
+#ifdef _WIN32
+	if (sleepTimer)
+		CloseHandle(sleepTimer);
+
+	sleepTimer = NULL;
+#endif
+}
+
+// Function that switches the present mode, the limiter starts counting from the next frame
+void setPresentMode(PresentMode mode)
+{
+	presentMode = mode;
+	nextFrame = 0;
+}
+
+PresentMode getPresentMode(void)
+{
+	return presentMode;
+}
+
+// Function for getting the printable name of a present mode
+const char* getPresentModeName(PresentMode mode)
+{
+	return modeNames[mode];
+}
+
+// Helper function for sleeping for about the given amount of performance counter units
+static void sleepFor(Uint64 counts)
+{
+	Uint64 frequency = SDL_GetPerformanceFrequency();
+
+#ifdef _WIN32
+	if (sleepTimer)
+	{
+		// Negative due times are relative, in 100 nanosecond units
+		LARGE_INTEGER due;
+		due.QuadPart = -(LONGLONG)(counts * 10000000 / frequency);
+
+		if (SetWaitableTimer(sleepTimer, &due, 0, NULL, NULL, FALSE))
+		{
+			WaitForSingleObject(sleepTimer, INFINITE);
+			return;
+		}
+	}
+#endif
+
+	SDL_Delay((Uint32)(counts * 1000 / frequency));
+}
+
+// Function that sleeps until shortly before the next limited frame is due and spins until it is
+void waitForNextFrame(void)
+{
+	if (presentMode != PRESENT_LIMITED)
+		return;
+
+	beginPhase(PHASE_FRAME_WAIT);
+
+	Uint64 now = SDL_GetPerformanceCounter();
+	Uint64 margin = SDL_GetPerformanceFrequency() * SPIN_MARGIN / 1000000;
+
+	// Start over instead of rushing through frames to catch up after a stall
+	if (nextFrame == 0 || now > nextFrame + framePeriod)
+		nextFrame = now;
+
+	if (nextFrame > now + margin)
+		sleepFor(nextFrame - now - margin);
+
+	while (SDL_GetPerformanceCounter() < nextFrame)
+		;
+
+	nextFrame += framePeriod;
+
+	endPhase(PHASE_FRAME_WAIT);
+}
+
+// Function that records the time between the last two presents
+void framePresented(void)
+{
+	Uint64 now = SDL_GetPerformanceCounter();
+
+	if (lastPresent != 0)
+		endPhaseSince(PHASE_FRAME_INTERVAL, lastPresent);
+
+	lastPresent = now;
+}
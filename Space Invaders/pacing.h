@@ -0,0 +1,53 @@
+#pragma once
+
+// SDL libraries
+#include <SDL.h>
+
+// Helper libraries
+#include <stdbool.h>
+
+#pragma region Structs and ENUMs
+
+// How frames are presented: waiting for the display, as fast as possible, or at a fixed rate
+typedef enum PresentMode { PRESENT_VSYNC, PRESENT_UNCAPPED, PRESENT_LIMITED, PRESENT_MODE_COUNT } PresentMode;
+
+// Mode and rate given with "--present vsync|uncapped|limited" and "--fps N"
+typedef struct PacingOptions
+{
+	PresentMode mode;
+	int fps; // Frame rate of the limiter
+} PacingOptions;
+
+#pragma endregion
+
+#pragma region Globals and defines
+
+// Default frame rate of the limiter
+#define DEFAULT_FPS 60
+
+// The limiter sleeps until this long before a frame is due and spins for the rest, in microseconds
+#define SPIN_MARGIN 1500
+
+#pragma endregion
+
+#pragma region Function declarations
+
+// Parse pacing options from the command line
+void parsePacingOptions(int argc, char* argv[], PacingOptions* options);
+
+// Initialization and exit
+bool initPacing(const PacingOptions* options);
+void quitPacing(void);
+
+// Switch the mode at runtime, the render thread switches vsync when it sees the mode of a frame change
+void setPresentMode(PresentMode mode);
+PresentMode getPresentMode(void);
+const char* getPresentModeName(PresentMode mode);
+
+// Wait until the next frame is due. Called before input is read, so the frame is simulated and rendered from the freshest input
+void waitForNextFrame(void);
+
+// Mark that a frame was presented, the time between presents goes to the profiler
+void framePresented(void);
+
+#pragma endregion
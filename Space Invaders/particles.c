@@ -0,0 +1,77 @@
+#include "particles.h"
+
+// Function for getting the size of the block holding every array of a particle emitter
+size_t getParticleEmitterSize(int capacity)
+{
+	size_t floats = sizeof(float) * (size_t)capacity * 5;
+	size_t ticks = sizeof(Uint32) * (size_t)capacity;
+	size_t types = sizeof(Uint8) * (size_t)capacity;
+
+	return floats + ticks + types;
+}
+
+// Function that points the arrays of a particle emitter into a block, without touching its contents
+void bindParticleEmitter(ParticleEmitter* emitter, void* memory, int capacity)
+{
+	char* block = (char*)memory;
+
+	size_t floats = sizeof(float) * (size_t)capacity * 5;
+	size_t ticks = sizeof(Uint32) * (size_t)capacity;
+
+	emitter->capacity = capacity;
+
+	emitter->px = (float*)block;
+	emitter->py = emitter->px + capacity;
+	emitter->vx = emitter->py + capacity;
+	emitter->vy = emitter->vx + capacity;
+	emitter->size = emitter->vy + capacity;
+
+	emitter->birth = (Uint32*)(block + floats);
+	emitter->type = (Uint8*)(block + floats + ticks);
+}
+
+// Kill every particle, the slots are simply overwritten by the next ones
+void clearParticles(ParticleEmitter* emitter)
+{
+	emitter->head = 0;
+	emitter->count = 0;
+}
+
+// Function that writes a particle into the slot after the newest one
+int emitParticle(ParticleEmitter* emitter, float px, float py, float vx, float vy, float size, Uint8 type)
+{
+	if (emitter->capacity == 0)
+		return -1;
+
+	// A full emitter drops its oldest particle, which is the one closest to fading out anyway
+	if (emitter->count == emitter->capacity)
+	{
+		emitter->head = getParticleSlot(emitter, 1);
+		emitter->count--;
+	}
+
+	int slot = getParticleSlot(emitter, emitter->count);
+	emitter->count++;
+
+	emitter->px[slot] = px;
+	emitter->py[slot] = py;
+	emitter->vx[slot] = vx;
+	emitter->vy[slot] = vy;
+	emitter->size[slot] = size;
+	emitter->birth[slot] = emitter->tick;
+	emitter->type[slot] = type;
+
+	return slot;
+}
+
+// Function that advances the emitter clock and pops every particle at the head that has lived for its lifetime
+void advanceParticles(ParticleEmitter* emitter)
+{
+	emitter->tick++;
+
+	while (emitter->count > 0 && emitter->tick - emitter->birth[emitter->head] >= emitter->lifetime)
+	{
+		emitter->head = getParticleSlot(emitter, 1);
+		emitter->count--;
+	}
+}
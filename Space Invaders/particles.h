@@ -0,0 +1,65 @@
+#pragma once
+
+// SDL libraries
+#include <SDL.h>
+
+// Helper libraries
+#include <stdbool.h>
+
+#pragma region Structs
+
+// Fixed-capacity ring buffer of particles. Every particle lives for the same amount of ticks,
+// so the oldest particle is always at the head and expiring is popping the head.
+// Particles move in a straight line from where they were emitted, their position and age are worked out from the tick they were born on.
+typedef struct ParticleEmitter
+{
+	int capacity; // Maximum amount of particles, the oldest particle is replaced when it's full
+	int head; // Slot of the oldest live particle
+	int count; // Amount of live particles, they are in the slots following the head
+
+	Uint32 tick; // Ticks advanced since the emitter was created
+	Uint32 lifetime; // Ticks every particle lives for
+
+	float* px, * py; // Coordinates when emitted
+	float* vx, * vy; // Velocity in pixels per second
+	float* size; // Width and height
+	Uint32* birth; // Tick the particle was emitted on
+	Uint8* type; // Particle type, maps onto a sprite
+} ParticleEmitter;
+
+#pragma endregion
+
+#pragma region Function declarations
+
+// Placement inside memory owned by someone else. Binding only sets the pointers, so a copied block can be bound again
+size_t getParticleEmitterSize(int capacity);
+void bindParticleEmitter(ParticleEmitter* emitter, void* memory, int capacity);
+
+// Constant time reset, kills every particle
+void clearParticles(ParticleEmitter* emitter);
+
+// Add a particle, replacing the oldest one if the emitter is full. Returns its slot
+int emitParticle(ParticleEmitter* emitter, float px, float py, float vx, float vy, float size, Uint8 type);
+
+// Advance by one tick and drop the particles that ran out. Costs nothing per live particle
+void advanceParticles(ParticleEmitter* emitter);
+
+#pragma endregion
+
+#pragma region Inline helpers
+
+// Slot of the nth oldest live particle
+static inline int getParticleSlot(const ParticleEmitter* emitter, int n)
+{
+	int slot = emitter->head + n;
+	return slot >= emitter->capacity ? slot - emitter->capacity : slot;
+}
+
+// Age of a particle in ticks, alpha is how far the frame is between the last two ticks
+static inline float getParticleAge(const ParticleEmitter* emitter, int slot, float alpha)
+{
+	float age = (float)(emitter->tick - emitter->birth[slot]) - 1.0f + alpha;
+	return age > 0.0f ? age : 0.0f;
+}
+
+#pragma endregion
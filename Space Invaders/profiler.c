@@ -0,0 +1,211 @@
+#include "profiler.h"
+
+// Standard libraries
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#pragma region Structs
+
+// Samples and running totals of a single phase. Only the thread that times the phase touches the start, the rest is read by the
+// other thread too and only changes or gets copied under the lock
+typedef struct PhaseTimer
+{
+	Uint64 start; // Counter value at the start of the current run
+
+	SDL_SpinLock lock;
+
+	float samples[PROFILE_WINDOW]; // Recent durations in microseconds, oldest overwritten first
+	int next; // Where to write the next sample
+	int filled; // Amount of valid samples
+
+	Uint64 calls;
+	double total;
+	double max;
+} PhaseTimer;
+
+#pragma endregion
+
+#pragma region Globals
+
+static PhaseTimer timers[PHASE_COUNT];
+
+static bool profiling = false;
+static double microsecondsPerCount = 0.0;
+
+static const char* phaseNames[PHASE_COUNT] = {
+	"input",
+	"updatePlayer",
+	"updateBullets",
+	"updateParticles",
+	"enemyShoot",
+	"checkBulletCollisions",
+	"checkGameState",
+	"updateEnemies",
+	"buildDrawList",
+	"renderStats",
+	"renderEntities",
+	"SDL_RenderPresent",
+	"frame",
+	"frameWait",
+	"renderWait",
+	"frameInterval",
+	"inputLatency",
+};
+
+#pragma endregion
+
+// Function for getting the profiler options from the command line
+void parseProfilerOptions(int argc, char* argv[], ProfilerOptions* options)
+{
+	options->outputPath = NULL;
+	options->logging = false;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--profile-out") == 0 && i + 1 < argc)
+			options->outputPath = argv[++i];
+		else if (strcmp(argv[i], "--log") == 0)
+			options->logging = true;
+	}
+}
+
+// Function that turns the timing of phases on or off
+void setProfiling(bool enabled)
+{
+	profiling = enabled;
+	microsecondsPerCount = 1000000.0 / (double)SDL_GetPerformanceFrequency();
+}
+
+// Function that marks the start of a phase
+void beginPhase(ProfilePhase phase)
+{
+	if (profiling)
+		timers[phase].start = SDL_GetPerformanceCounter();
+}
+
+// Function that marks the end of a phase and stores how long it took
+void endPhase(ProfilePhase phase)
+{
+	if (!profiling)
+		return;
+
+	PhaseTimer* timer = &timers[phase];
+	double duration = (double)(SDL_GetPerformanceCounter() - timer->start) * microsecondsPerCount;
+
+	SDL_AtomicLock(&timer->lock);
+
+	timer->samples[timer->next] = (float)duration;
+	timer->next = (timer->next + 1) % PROFILE_WINDOW;
+	if (timer->filled < PROFILE_WINDOW)
+		timer->filled++;
+
+	timer->calls++;
+	timer->total += duration;
+	if (duration > timer->max)
+		timer->max = duration;
+
+	SDL_AtomicUnlock(&timer->lock);
+}
+
+// Function that ends a phase which started at a counter value taken elsewhere, like the time of an input event
+void endPhaseSince(ProfilePhase phase, Uint64 start)
+{
+	timers[phase].start = start;
+	endPhase(phase);
+}
+
+// Function for getting the printable name of a phase
+const char* getPhaseName(ProfilePhase phase)
+{
+	return phaseNames[phase];
+}
+
+// Helper function for sorting samples
+static int compareSamples(const void* a, const void* b)
+{
+	float x = *(const float*)a;
+	float y = *(const float*)b;
+
+	return (x > y) - (x < y);
+}
+
+// Function for getting the stats of a phase, from any thread
+void getPhaseStats(ProfilePhase phase, PhaseStats* stats)
+{
+	PhaseTimer* timer = &timers[phase];
+
+	memset(stats, 0, sizeof *stats);
+
+	// Sort a copy, the order of the samples is needed for overwriting the oldest one. Only the copy is taken under the lock,
+	// so the thread timing the phase never waits for the sort
+	float sorted[PROFILE_WINDOW];
+
+	SDL_AtomicLock(&timer->lock);
+
+	stats->calls = timer->calls;
+	stats->total = timer->total;
+	stats->max = timer->max;
+
+	int filled = timer->filled;
+	memcpy(sorted, timer->samples, filled * sizeof(float));
+
+	SDL_AtomicUnlock(&timer->lock);
+
+	if (filled == 0)
+		return;
+
+	qsort(sorted, filled, sizeof(float), compareSamples);
+
+	double sum = 0.0;
+	for (int i = 0; i < filled; i++)
+		sum += sorted[i];
+
+	stats->min = sorted[0];
+	stats->avg = sum / filled;
+	stats->p99 = sorted[(filled - 1) * 99 / 100];
+}
+
+// Function that writes the stats of every phase, as JSON if the path ends with .json and as CSV otherwise
+bool writeProfile(const char* path)
+{
+	FILE* file = fopen(path, "w");
+	if (!file)
+	{
+		printf("Couldn't open %s for the profile\n", path);
+		return false;
+	}
+
+	size_t length = strlen(path);
+	bool json = length >= 5 && strcmp(path + length - 5, ".json") == 0;
+
+	if (json)
+		fprintf(file, "{\n\t\"window\": %d,\n\t\"phases\": [\n", PROFILE_WINDOW);
+	else
+		fprintf(file, "phase,calls,total_ms,min_us,avg_us,p99_us,max_us\n");
+
+	for (int phase = 0; phase < PHASE_COUNT; phase++)
+	{
+		PhaseStats stats;
+		getPhaseStats(phase, &stats);
+
+		if (json)
+		{
+			fprintf(file, "\t\t{ \"phase\": \"%s\", \"calls\": %llu, \"total_ms\": %.3f, \"min_us\": %.3f, \"avg_us\": %.3f, \"p99_us\": %.3f, \"max_us\": %.3f }%s\n",
+				phaseNames[phase], (unsigned long long)stats.calls, stats.total / 1000.0,
+				stats.min, stats.avg, stats.p99, stats.max, phase + 1 < PHASE_COUNT ? "," : "");
+		}
+		else
+		{
+			fprintf(file, "%s,%llu,%.3f,%.3f,%.3f,%.3f,%.3f\n",
+				phaseNames[phase], (unsigned long long)stats.calls, stats.total / 1000.0,
+				stats.min, stats.avg, stats.p99, stats.max);
+		}
+	}
+
+	if (json)
+		fprintf(file, "\t]\n}\n");
+
+	fclose(file);
+	return true;
+}
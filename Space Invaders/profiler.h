@@ -0,0 +1,80 @@
+#pragma once
+
+// SDL libraries
+#include <SDL.h>
+
+// Helper libraries
+#include <stdbool.h>
+
+#pragma region Structs and ENUMs
+
+// Timed phases of a frame, in the order they run. Every phase is only timed on one thread, the render phases on the render thread
+typedef enum ProfilePhase
+{
+	PHASE_INPUT,
+	PHASE_PLAYER,
+	PHASE_BULLETS,
+	PHASE_PARTICLES,
+	PHASE_ENEMY_SHOOT,
+	PHASE_COLLISIONS,
+	PHASE_GAME_STATE,
+	PHASE_ENEMIES,
+	PHASE_DRAW_LIST, // Copying the frame out of the world for the render thread
+	PHASE_RENDER_STATS,
+	PHASE_RENDER_ENTITIES,
+	PHASE_PRESENT,
+	PHASE_FRAME,
+	PHASE_FRAME_WAIT, // Time the frame limiter waited before the frame
+	PHASE_RENDER_WAIT, // Time the frame waited for the render thread to take the last one
+	PHASE_FRAME_INTERVAL, // From one present to the next
+	PHASE_INPUT_LATENCY, // From an input event to the present of the first frame that shows it
+	PHASE_COUNT
+} ProfilePhase;
+
+// Stats of a phase in microseconds. Min, avg and p99 cover the most recent samples only
+typedef struct PhaseStats
+{
+	Uint64 calls; // Amount of times the phase has run
+	double total; // Time spent in the phase since the start
+
+	double min, avg, p99; // Over the last PROFILE_WINDOW samples
+	double max; // Since the start
+} PhaseStats;
+
+// Paths and flags given with "--profile-out FILE" and "--log"
+typedef struct ProfilerOptions
+{
+	const char* outputPath; // .json writes JSON, anything else CSV. NULL if not given
+	bool logging; // Print hot path log messages, off by default
+} ProfilerOptions;
+
+#pragma endregion
+
+#pragma region Globals and defines
+
+// Amount of recent samples kept for each phase
+#define PROFILE_WINDOW 512
+
+#pragma endregion
+
+#pragma region Function declarations
+
+// Parse profiler options from the command line
+void parseProfilerOptions(int argc, char* argv[], ProfilerOptions* options);
+
+// Turn timing on or off. Phases are not timed until this is called
+void setProfiling(bool enabled);
+
+// Timing of a phase, every begin has to be followed by an end of the same phase
+void beginPhase(ProfilePhase phase);
+void endPhase(ProfilePhase phase);
+void endPhaseSince(ProfilePhase phase, Uint64 start);
+
+// Stats, safe to read from any thread. Stats of a phase timed on another thread can be a sample behind
+const char* getPhaseName(ProfilePhase phase);
+void getPhaseStats(ProfilePhase phase, PhaseStats* stats);
+
+// Write the stats of every phase to a CSV or JSON file
+bool writeProfile(const char* path);
+
+#pragma endregion
@@ -0,0 +1,617 @@
+#include "render.h"
+
+// SDL libraries
+#include <SDL_ttf.h>
+#include <SDL_image.h>
+
+// Game modules
+#include "assets.h"
+#include "drawlist.h"
+#include "game.h"
+#include "input.h"
+#include "pacing.h"
+#include "profiler.h"
+#include "scores.h"
+#include "sprites.h"
+#include "text.h"
+
+// Standard libraries
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#pragma region Globals
+
+// Global pointers for SDL
+SDL_Window* window = NULL;
+SDL_Renderer* renderer = NULL;
+
+// Atlas with the sprites of every entity, and the batch that all entities are drawn with
+SpriteAtlas sprite_atlas;
+SpriteBatch sprite_batch;
+
+// Sprites that may still be decoding while the menu shows. Failing to load them is only reported once
+SpriteLoader sprite_loader;
+bool sprites_failed = false;
+
+// Point sizes of the game and menu text, both rendered from the same font
+#define GAME_FONT_SIZE 18
+#define MENU_FONT_SIZE 64
+
+// Glyph atlas for the game font and pre-rendered static menu strings
+GlyphAtlas game_glyphs;
+CachedText menu_title;
+CachedText menu_prompt;
+
+// HUD numbers, only reformatted when their value changes
+HudNumber hud_score = { .label = "Score: " };
+HudNumber hud_hiscore = { .label = "High score: " };
+HudNumber hud_lives = { .label = "Lives: " };
+HudNumber hud_wave = { .label = "Wave: " };
+
+// The HUD and the menu are composed into their own textures, and only composed again when something on them changes
+#define HUD_HEIGHT 64
+
+// HUD lines in logical pixels: the score on the left, the lives and wave in a column at the right of the window
+#define HUD_MARGIN 10
+#define HUD_RIGHT_COLUMN (WINDOW_WIDTH - 120)
+#define HUD_FIRST_LINE 15
+#define HUD_LINE_HEIGHT 20
+
+TextLayer hud_layer;
+TextLayer menu_layer;
+
+// Profiler overlay, toggled with a hotkey. Its text is refreshed every few frames so it stays readable
+#define PROFILER_REFRESH_FRAMES 30
+#define PROFILER_COLUMNS 3
+
+bool showProfiler = false;
+
+static char profiler_text[PHASE_COUNT][PROFILER_COLUMNS][16];
+static int profiler_frames = 0;
+
+// Frames on their way from the simulation to the render thread
+static DrawQueue draw_queue;
+
+// Render thread, and whether it could create the renderer and everything drawn with it. It owns the renderer from start to end
+static SDL_Thread* render_thread = NULL;
+static SDL_sem* render_ready = NULL;
+static bool render_success = false;
+
+// Whether presents wait for the display
+static bool render_vsync = false;
+
+// Everything is drawn at the logical size into the frame target, which a single copy then scales up to the window by a whole factor.
+// The logical size is the window size, or the field when the formation needs more room
+static int logical_width = WINDOW_WIDTH, logical_height = WINDOW_HEIGHT;
+static SDL_Texture* frame_target = NULL;
+
+// Set on the main thread when render targets lose their contents, and handled on the render thread
+static SDL_atomic_t layers_lost;
+
+#pragma endregion
+
+#pragma region Function forward declarations
+
+// Render thread
+static int renderThread(void* data);
+static bool initRenderThread(void);
+static void quitRenderThread(void);
+static void drawFrame(const DrawList* list);
+static bool createFrameTarget(void);
+static void presentFrameTarget(void);
+
+#pragma endregion
+
+// Function that picks up "--fullscreen" and "--scale N" from the command line
+void parseDisplayOptions(int argc, char* argv[], DisplayOptions* options)
+{
+	options->fullscreen = false;
+	options->scale = 1;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--fullscreen") == 0)
+			options->fullscreen = true;
+		else if (strcmp(argv[i], "--scale") == 0 && i + 1 < argc)
+			options->scale = atoi(argv[++i]);
+	}
+
+	options->scale = max(1, min(options->scale, MAX_WINDOW_SCALE));
+}
+
+// Function that initializes the window, and starts the render thread with the renderer, fonts and textures
+bool initRender(bool vsync, const DisplayOptions* display)
+{
+	bool success = true;
+
+	// Initialize the TTF library (text rendering)
+	if (TTF_Init() != 0) {
+		printf("Couldn't initialize SDL: %s", TTF_GetError());
+		success = false;
+	}
+
+	if ((IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG) != IMG_INIT_PNG) {
+		printf("SDL_image could not initialize! SDL_image Error: %s", IMG_GetError());
+		success = false;
+	}
+
+	// Set render scale quality to 0 for the crispiest pixel art
+	SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "0");
+
+	// Start decoding the sprites, they are only needed once the game starts
+	startLoadingSprites(&sprite_loader);
+
+	// The window stays on this thread, which handles its events. High DPI displays get a drawable at their real resolution,
+	// which the frame is scaled up to like any other window
+	Uint32 flags = SDL_WINDOW_ALLOW_HIGHDPI | (display->fullscreen ? SDL_WINDOW_FULLSCREEN_DESKTOP : 0);
+
+	window = SDL_CreateWindow("Space Invaders", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
+		WINDOW_WIDTH * display->scale, WINDOW_HEIGHT * display->scale, flags);
+	if (!window) {
+		printf("Couldn't create the window: %s\n", SDL_GetError());
+		return false;
+	}
+
+	// A field larger than the window is drawn whole and scaled down to fit it
+	logical_width = max(WINDOW_WIDTH, (int)gameWorld.config.fieldWidth);
+	logical_height = max(WINDOW_HEIGHT, (int)gameWorld.config.fieldHeight);
+
+	// One sprite for every ship and for every entity slot
+	if (!createDrawQueue(&draw_queue, MAX_PLAYERS + gameWorld.enemies.capacity + gameWorld.bullets.capacity + gameWorld.particles.capacity))
+		return false;
+
+	render_vsync = vsync;
+	SDL_AtomicSet(&layers_lost, 0);
+
+	// The renderer is created on the render thread, the first frame waits until it's ready
+	render_ready = SDL_CreateSemaphore(0);
+	render_thread = render_ready ? SDL_CreateThread(renderThread, "Render", NULL) : NULL;
+
+	if (!render_thread) {
+		printf("Couldn't start the render thread: %s\n", SDL_GetError());
+		return false;
+	}
+
+	SDL_SemWait(render_ready);
+
+	return success && render_success;
+}
+
+// Free everything used for rendering
+void quitRender(void)
+{
+	// The render thread frees everything drawn with the renderer, and the renderer itself, on its way out
+	if (render_thread)
+	{
+		stopDrawQueue(&draw_queue);
+		SDL_WaitThread(render_thread, NULL);
+		render_thread = NULL;
+	}
+
+	SDL_DestroySemaphore(render_ready);
+	render_ready = NULL;
+
+	freeDrawQueue(&draw_queue);
+
+	SDL_DestroyWindow(window);
+	window = NULL;
+
+	// Wait for the loader in case the game never started
+	finishLoadingSprites(&sprite_loader);
+	freeSpriteSheet(&sprite_loader.sheet);
+
+	TTF_Quit();
+	IMG_Quit();
+}
+
+// Main render function, copies the frame out of the world and hands it to the render thread. Alpha is how far the frame is between the last two ticks
+void render(float alpha)
+{
+	beginPhase(PHASE_DRAW_LIST);
+
+	DrawList* list = beginDrawList(&draw_queue);
+
+	buildDrawList(list, &gameWorld, alpha);
+
+	// The HUD shows the best score of every session, the world only knows the games it has played itself
+	list->hiScore = max(list->hiScore, getBestScore());
+
+	list->presentMode = getPresentMode();
+	list->showProfiler = showProfiler;
+	list->inputTime = takeInputLatencyStart();
+
+	publishDrawList(&draw_queue);
+
+	endPhase(PHASE_DRAW_LIST);
+}
+
+// Function that waits for the render thread to take the last frame. A slow or stalled render thread only holds the simulation up for a while
+void waitForRenderThread(void)
+{
+	beginPhase(PHASE_RENDER_WAIT);
+	waitForDrawListTaken(&draw_queue, RENDER_WAIT_TIMEOUT);
+	endPhase(PHASE_RENDER_WAIT);
+}
+
+// Function for getting the frames that were never drawn since the last call, only the simulation touches the count
+int takeDroppedFrames(void)
+{
+	int dropped = draw_queue.dropped;
+	draw_queue.dropped = 0;
+
+	return dropped;
+}
+
+#pragma region Render thread
+
+// Function that runs on the render thread, it draws every frame it gets from the queue until the queue stops
+static int renderThread(void* data)
+{
+	render_success = initRenderThread();
+	SDL_SemPost(render_ready);
+
+	// Draw nothing when it failed, the program is already on its way out
+	const DrawList* list;
+	while ((list = takeDrawList(&draw_queue)) != NULL)
+	{
+		if (render_success)
+			drawFrame(list);
+	}
+
+	quitRenderThread();
+
+	return 0;
+}
+
+// Function that creates the renderer, fonts and textures on the render thread
+static bool initRenderThread(void)
+{
+	bool success = true;
+
+	renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | (render_vsync ? SDL_RENDERER_PRESENTVSYNC : 0));
+	if (!renderer) {
+		printf("Couldn't create the renderer: %s\n", SDL_GetError());
+		return false;
+	}
+
+	if (!createFrameTarget())
+		printf("The frame is scaled without a render target\n");
+
+	// Open the font once and rasterize it at both sizes, it isn't needed after that
+	SDL_RWops* fontFile = openFontAsset();
+	TTF_Font* font = fontFile ? TTF_OpenFontRW(fontFile, 1, MENU_FONT_SIZE) : NULL;
+
+	if (!font)
+	{
+		printf("Couldn't open font: %s\n", TTF_GetError());
+		success = false;
+	}
+	else if (!createTextCaches(font))
+	{
+		success = false;
+	}
+
+	TTF_CloseFont(font);
+
+	if (!createSpriteBatch(&sprite_batch, draw_queue.lists[0].capacity))
+		success = false;
+
+	return success;
+}
+
+// Function that frees everything drawn with the renderer, then the renderer, on the thread they were created on
+static void quitRenderThread(void)
+{
+	SDL_DestroyTexture(frame_target);
+	frame_target = NULL;
+
+	freeTextCaches();
+	freeSpriteAtlas(&sprite_atlas);
+	freeSpriteBatch(&sprite_batch);
+
+	SDL_DestroyRenderer(renderer);
+	renderer = NULL;
+}
+
+// Function that creates the target every frame is drawn into at the logical size. Without render targets, the renderer scales every
+// draw call to the window instead, which looks the same but fills every pixel of the window for every sprite
+static bool createFrameTarget(void)
+{
+	frame_target = SDL_RenderTargetSupported(renderer) ?
+		SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, logical_width, logical_height) : NULL;
+
+	if (frame_target)
+	{
+		// Nearest neighbour, so every pixel of the frame becomes a sharp square of pixels on the screen
+		SDL_SetTextureScaleMode(frame_target, SDL_ScaleModeNearest);
+		return true;
+	}
+
+	SDL_RenderSetLogicalSize(renderer, logical_width, logical_height);
+
+	// Whole factors only work when the frame fits the window at least once
+	int outputWidth, outputHeight;
+	if (SDL_GetRendererOutputSize(renderer, &outputWidth, &outputHeight) == 0 && outputWidth >= logical_width && outputHeight >= logical_height)
+		SDL_RenderSetIntegerScale(renderer, SDL_TRUE);
+
+	return false;
+}
+
+// Function for getting where the frame goes on the screen: scaled up by the largest whole factor that fits and centered, with black around it.
+// A frame larger than the screen is scaled down to fit instead
+static SDL_Rect getFrameRect(void)
+{
+	int outputWidth = logical_width, outputHeight = logical_height;
+	SDL_GetRendererOutputSize(renderer, &outputWidth, &outputHeight);
+
+	SDL_Rect rect = { .w = logical_width, .h = logical_height };
+	int scale = min(outputWidth / logical_width, outputHeight / logical_height);
+
+	if (scale >= 1)
+	{
+		rect.w *= scale;
+		rect.h *= scale;
+	}
+	else
+	{
+		float fit = min((float)outputWidth / (float)logical_width, (float)outputHeight / (float)logical_height);
+		rect.w = (int)((float)logical_width * fit);
+		rect.h = (int)((float)logical_height * fit);
+	}
+
+	rect.x = (outputWidth - rect.w) / 2;
+	rect.y = (outputHeight - rect.h) / 2;
+
+	return rect;
+}
+
+// Function that copies the finished frame to the screen in a single scaled draw
+static void presentFrameTarget(void)
+{
+	SDL_SetRenderTarget(renderer, NULL);
+
+	SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+	SDL_RenderClear(renderer);
+
+	SDL_Rect rect = getFrameRect();
+	SDL_RenderCopy(renderer, frame_target, NULL, &rect);
+}
+
+// Helper function that switches vsync after the renderer has been created
+static void setRenderVSync(bool vsync)
+{
+	if (SDL_RenderSetVSync(renderer, vsync ? 1 : 0) != 0)
+		printf("Couldn't switch vsync: %s\n", SDL_GetError());
+
+	render_vsync = vsync;
+}
+
+// Function that draws and presents a frame on the render thread
+static void drawFrame(const DrawList* list)
+{
+	// Vsync follows the present mode the frame was built with
+	bool vsync = list->presentMode == PRESENT_VSYNC;
+	if (vsync != render_vsync)
+		setRenderVSync(vsync);
+
+	if (SDL_AtomicSet(&layers_lost, 0))
+	{
+		hud_layer.dirty = true;
+		menu_layer.dirty = true;
+	}
+
+	if (frame_target)
+		SDL_SetRenderTarget(renderer, frame_target);
+
+	SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+	SDL_RenderClear(renderer);
+
+	// The sprites are uploaded when the game first needs them, they have usually finished decoding by then
+	if (list->playGame && !sprite_atlas.texture && !sprites_failed)
+		uploadSprites();
+
+	if (list->playGame)
+	{
+		beginPhase(PHASE_RENDER_STATS);
+		renderStats(list);
+		endPhase(PHASE_RENDER_STATS);
+
+		beginPhase(PHASE_RENDER_ENTITIES);
+		renderEntities(list);
+		endPhase(PHASE_RENDER_ENTITIES);
+	}
+	else
+	{
+		renderMenu();
+	}
+
+	if (list->showProfiler)
+		renderProfiler(list->presentMode);
+
+	if (frame_target)
+		presentFrameTarget();
+
+	beginPhase(PHASE_PRESENT);
+	SDL_RenderPresent(renderer);
+	endPhase(PHASE_PRESENT);
+
+	// The frame with the result of the newest input has been presented
+	if (list->inputTime != 0)
+		endPhaseSince(PHASE_INPUT_LATENCY, list->inputTime);
+
+	framePresented();
+}
+
+#pragma endregion
+
+// Helper function for drawing every line of the HUD from the glyph atlas
+static void drawHud(void)
+{
+	SDL_Color color = { 255,255,255,255 };
+
+	drawAtlasText(renderer, &game_glyphs, hud_score.text, color, HUD_MARGIN, HUD_FIRST_LINE);
+	drawAtlasText(renderer, &game_glyphs, hud_hiscore.text, color, HUD_MARGIN, HUD_FIRST_LINE + HUD_LINE_HEIGHT);
+	drawAtlasText(renderer, &game_glyphs, hud_lives.text, color, HUD_RIGHT_COLUMN, HUD_FIRST_LINE);
+	drawAtlasText(renderer, &game_glyphs, hud_wave.text, color, HUD_RIGHT_COLUMN, HUD_FIRST_LINE + HUD_LINE_HEIGHT);
+}
+
+// Function for rendering the stats of a frame on screen
+void renderStats(const DrawList* list)
+{
+	// The text of each line is rebuilt only when the number changes, and the HUD layer only when a line was rebuilt
+	bool changed = updateHudNumber(&hud_score, list->score);
+	changed |= updateHudNumber(&hud_hiscore, list->hiScore);
+	changed |= updateHudNumber(&hud_lives, list->livesLeft);
+	changed |= updateHudNumber(&hud_wave, list->wave);
+
+	if ((changed || hud_layer.dirty) && beginTextLayer(&hud_layer, renderer))
+	{
+		drawHud();
+		endTextLayer(&hud_layer, renderer);
+	}
+
+	if (hud_layer.texture)
+		drawTextLayer(renderer, &hud_layer, 0, 0);
+	else
+		drawHud();
+}
+
+// Function for rendering every sprite of a frame with a single batched draw call
+void renderEntities(const DrawList* list)
+{
+	for (int n = 0; n < list->count; n++)
+	{
+		const DrawSprite* sprite = &list->sprites[n];
+
+		// Animations play over the frames the atlas has for the sprite
+		int frame = (int)(sprite->progress * (float)sprite_atlas.frames[sprite->sprite]);
+
+		addSpriteFrame(&sprite_batch, &sprite_atlas, sprite->sprite, frame, sprite->px, sprite->py, sprite->w, sprite->h, sprite->color);
+	}
+
+	flushSpriteBatch(&sprite_batch, renderer, &sprite_atlas);
+}
+
+// Function for creating the glyph atlas and the static menu strings
+bool createTextCaches(TTF_Font* font)
+{
+	SDL_Color white = { 255,255,255,255 };
+
+	bool success = createCachedText(&menu_title, renderer, font, "SPACE INVADERS", white);
+	success &= createCachedText(&menu_prompt, renderer, font, "Press space to play", white);
+
+	// Switch the font to the size of the game text
+	if (TTF_SetFontSize(font, GAME_FONT_SIZE) != 0)
+		success = false;
+
+	success &= createGlyphAtlas(&game_glyphs, renderer, font);
+
+	// Without render targets the text is drawn straight to the screen every frame instead
+	if (!createTextLayer(&hud_layer, renderer, WINDOW_WIDTH, HUD_HEIGHT) ||
+		!createTextLayer(&menu_layer, renderer, WINDOW_WIDTH, WINDOW_HEIGHT))
+		printf("Text is drawn without layers\n");
+
+	return success;
+}
+
+// Function that waits for the sprite sheet and uploads it as the sprite atlas
+bool uploadSprites(void)
+{
+	bool success = finishLoadingSprites(&sprite_loader) && createSpriteAtlas(&sprite_atlas, renderer, &sprite_loader.sheet);
+
+	// The pixels are on the GPU now
+	freeSpriteSheet(&sprite_loader.sheet);
+
+	if (!success)
+	{
+		printf("Sprites couldn't be loaded, entities are drawn without them\n");
+		sprites_failed = true;
+	}
+
+	return success;
+}
+
+// Free the textures used for text rendering
+void freeTextCaches(void)
+{
+	freeGlyphAtlas(&game_glyphs);
+	freeCachedText(&menu_title);
+	freeCachedText(&menu_prompt);
+	freeTextLayer(&hud_layer);
+	freeTextLayer(&menu_layer);
+}
+
+// The contents of render targets are lost when the renderer resets them, so both layers are composed again on the next frame
+void invalidateTextLayers(void)
+{
+	SDL_AtomicSet(&layers_lost, 1);
+}
+
+// Helper function for drawing the text of the main menu
+static void drawMenu(void)
+{
+	// Title, centered near the top
+	drawCachedText(renderer, &menu_title, (WINDOW_WIDTH - menu_title.w) / 2, 35);
+
+	// Draw button text, centered just above the middle
+	drawCachedText(renderer, &menu_prompt, (WINDOW_WIDTH - menu_prompt.w) / 2, WINDOW_HEIGHT / 2 - 35);
+}
+
+// Function for rendering the main menu, which never changes once it has been composed
+void renderMenu(void) 
+{
+	if (menu_layer.dirty && beginTextLayer(&menu_layer, renderer))
+	{
+		drawMenu();
+		endTextLayer(&menu_layer, renderer);
+	}
+
+	if (menu_layer.texture)
+		drawTextLayer(renderer, &menu_layer, 0, 0);
+	else
+		drawMenu();
+}
+
+// Function for rendering the min, avg and p99 time of every phase over the game
+void renderProfiler(PresentMode mode)
+{
+	SDL_Color white = { 255,255,255,255 };
+	SDL_Color gray = { 160,160,160,255 };
+
+	if (profiler_frames++ % PROFILER_REFRESH_FRAMES == 0)
+	{
+		for (int phase = 0; phase < PHASE_COUNT; phase++)
+		{
+			PhaseStats stats;
+			getPhaseStats(phase, &stats);
+
+			snprintf(profiler_text[phase][0], sizeof profiler_text[phase][0], "%.1f", stats.min);
+			snprintf(profiler_text[phase][1], sizeof profiler_text[phase][1], "%.1f", stats.avg);
+			snprintf(profiler_text[phase][2], sizeof profiler_text[phase][2], "%.1f", stats.p99);
+		}
+	}
+
+	// Darken the game behind the overlay
+	SDL_Rect background = { 5, 60, 430, 30 + PHASE_COUNT * 20 };
+	SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+	SDL_SetRenderDrawColor(renderer, 0, 0, 0, 192);
+	SDL_RenderFillRect(renderer, &background);
+
+	static const char* headers[PROFILER_COLUMNS] = { "min us", "avg us", "p99 us" };
+	for (int column = 0; column < PROFILER_COLUMNS; column++)
+		drawAtlasText(renderer, &game_glyphs, headers[column], gray, 210 + column * 75, 65);
+
+	// Frame pacing depends on how frames are presented
+	drawAtlasText(renderer, &game_glyphs, getPresentModeName(mode), gray, 10, 65);
+
+	for (int phase = 0; phase < PHASE_COUNT; phase++)
+	{
+		int py = 85 + phase * 20;
+
+		drawAtlasText(renderer, &game_glyphs, getPhaseName(phase), white, 10, py);
+
+		for (int column = 0; column < PROFILER_COLUMNS; column++)
+			drawAtlasText(renderer, &game_glyphs, profiler_text[phase][column], white, 210 + column * 75, py);
+	}
+}
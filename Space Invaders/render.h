@@ -0,0 +1,68 @@
+#pragma once
+
+// SDL libraries
+#include <SDL.h>
+#include <SDL_ttf.h>
+
+// Game modules
+#include "drawlist.h"
+
+// Helper libraries
+#include <stdbool.h>
+
+#pragma region Globals and defines
+
+// Global pointers for SDL. The window belongs to the main thread, the renderer to the render thread
+extern SDL_Window* window;
+extern SDL_Renderer* renderer;
+
+// Whether the profiler overlay is drawn on top of the game
+extern bool showProfiler;
+
+// Largest window scale "--scale N" takes
+#define MAX_WINDOW_SCALE 8
+
+// How the window shows the game, "--fullscreen" covers the desktop and "--scale N" makes the window N times the logical size.
+// Either way the game is drawn at its logical size and scaled up by a whole factor
+typedef struct DisplayOptions
+{
+	bool fullscreen;
+	int scale;
+} DisplayOptions;
+
+// Longest the simulation waits for the render thread before it builds the next frame anyway, in milliseconds
+#define RENDER_WAIT_TIMEOUT 100
+
+#pragma endregion
+
+#pragma region Function declarations
+
+// Parse display options from the command line
+void parseDisplayOptions(int argc, char* argv[], DisplayOptions* options);
+
+// Initialization and exit. The window is created on the calling thread, the renderer and everything drawn with it on the render thread
+bool initRender(bool vsync, const DisplayOptions* display);
+void quitRender(void);
+
+// Main render method, hands the frame to the render thread. Alpha is how far the frame is between the last two ticks
+void render(float alpha);
+
+// Wait until the render thread has taken the last frame, so the simulation is never more than a frame ahead of it
+void waitForRenderThread(void);
+
+// Amount of frames handed over since the last call that were replaced before the render thread took them
+int takeDroppedFrames(void);
+
+// Compose the cached text layers again, their render targets lost their contents. Can be called from any thread
+void invalidateTextLayers(void);
+
+// Rendering, only called on the render thread
+bool createTextCaches(TTF_Font* font);
+bool uploadSprites(void);
+void freeTextCaches(void);
+void renderEntities(const DrawList* list);
+void renderStats(const DrawList* list);
+void renderMenu(void);
+void renderProfiler(PresentMode mode);
+
+#pragma endregion
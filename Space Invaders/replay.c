@@ -0,0 +1,357 @@
+#include "replay.h"
+
+// Game modules
+#include "bytes.h"
+#include "tunables.h"
+
+// Standard libraries
+#include <stdio.h>
+#include <string.h>
+
+// File layout:
+//   header: "SIRP", version (u16), tick rate (u16), seed (u32), the packed config and the hash of the tunables (u32), little-endian
+//   runs:   packed input byte followed by the run length as a varint
+//   footer: FOOTER_MARKER, tick count (u64), state hash (u32)
+#define REPLAY_MAGIC "SIRP"
+#define REPLAY_VERSION 4
+#define REPLAY_CONFIG_OFFSET 12
+#define REPLAY_TUNABLES_OFFSET (REPLAY_CONFIG_OFFSET + PACKED_CONFIG_SIZE)
+#define REPLAY_HEADER_SIZE (REPLAY_TUNABLES_OFFSET + 4)
+#define FOOTER_MARKER 0x80
+
+#pragma region Helpers
+
+// Bits of a float, so it's written and read back exactly
+static Uint32 floatBits(float value)
+{
+	Uint32 bits;
+	memcpy(&bits, &value, sizeof bits);
+	return bits;
+}
+
+// Float from its bits
+static float bitsFloat(Uint32 bits)
+{
+	float value;
+	memcpy(&value, &bits, sizeof value);
+	return value;
+}
+
+// Hash of the authored waves of a config, 0 for the progression of the original game
+static Uint32 hashConfigWaves(const GameConfig* config)
+{
+	return config->authoredWaves ? hashWaveSchedule(config->authoredWaves) : 0;
+}
+
+// Function that packs a config: formation columns and rows, bullet and particle capacity, enemy fire rate (f32), kill reward,
+// shoot cooldown (f32), speed increment (f32), field width and height (f32), players and the hash of the authored waves, 0 without them.
+// All u32 unless noted and little-endian
+void packGameConfig(const GameConfig* config, Uint8* out)
+{
+	writeLittleEndian(out, (Uint32)config->formationCols, 4);
+	writeLittleEndian(out + 4, (Uint32)config->formationRows, 4);
+	writeLittleEndian(out + 8, (Uint32)config->maxBullets, 4);
+	writeLittleEndian(out + 12, (Uint32)config->maxParticles, 4);
+	writeLittleEndian(out + 16, floatBits(config->enemyFireRate), 4);
+	writeLittleEndian(out + 20, (Uint32)config->killReward, 4);
+	writeLittleEndian(out + 24, floatBits(config->shootCooldown), 4);
+	writeLittleEndian(out + 28, floatBits(config->speedOffsetIncr), 4);
+	writeLittleEndian(out + 32, floatBits(config->fieldWidth), 4);
+	writeLittleEndian(out + 36, floatBits(config->fieldHeight), 4);
+	writeLittleEndian(out + 40, (Uint32)config->players, 4);
+	writeLittleEndian(out + 44, hashConfigWaves(config), 4);
+}
+
+// Function that unpacks a config over the given one, the authored waves it has are kept
+void unpackGameConfig(const Uint8* in, GameConfig* config)
+{
+	config->formationCols = (int)readLittleEndian(in, 4);
+	config->formationRows = (int)readLittleEndian(in + 4, 4);
+	config->maxBullets = (int)readLittleEndian(in + 8, 4);
+	config->maxParticles = (int)readLittleEndian(in + 12, 4);
+	config->enemyFireRate = bitsFloat((Uint32)readLittleEndian(in + 16, 4));
+	config->killReward = (int)readLittleEndian(in + 20, 4);
+	config->shootCooldown = bitsFloat((Uint32)readLittleEndian(in + 24, 4));
+	config->speedOffsetIncr = bitsFloat((Uint32)readLittleEndian(in + 28, 4));
+	config->fieldWidth = bitsFloat((Uint32)readLittleEndian(in + 32, 4));
+	config->fieldHeight = bitsFloat((Uint32)readLittleEndian(in + 36, 4));
+	config->players = (int)readLittleEndian(in + 40, 4);
+}
+
+// Pack an input into a single byte
+Uint8 packInput(const PlayerInput* input)
+{
+	return (Uint8)((input->left ? INPUT_LEFT : 0) | (input->right ? INPUT_RIGHT : 0) | (input->shoot ? INPUT_SHOOT : 0));
+}
+
+// Unpack an input from a single byte
+void unpackInput(Uint8 packed, PlayerInput* input)
+{
+	input->left = (packed & INPUT_LEFT) != 0;
+	input->right = (packed & INPUT_RIGHT) != 0;
+	input->shoot = (packed & INPUT_SHOOT) != 0;
+}
+
+// Write the current run as a packed input and a varint length
+static void flushRun(InputRecorder* recorder)
+{
+	if (recorder->run == 0)
+		return;
+
+	Uint8 buffer[6];
+	int length = 0;
+
+	buffer[length++] = recorder->current;
+
+	Uint32 run = recorder->run;
+	while (run >= 0x80)
+	{
+		buffer[length++] = (Uint8)(run | 0x80);
+		run >>= 7;
+	}
+	buffer[length++] = (Uint8)run;
+
+	SDL_RWwrite(recorder->file, buffer, 1, (size_t)length);
+	recorder->run = 0;
+}
+
+#pragma endregion
+
+// Function that picks up "--record FILE" and "--replay FILE" from the command line
+void parseReplayOptions(int argc, char* argv[], ReplayOptions* options)
+{
+	options->recordPath = NULL;
+	options->replayPath = NULL;
+
+	for (int i = 1; i < argc - 1; i++)
+	{
+		if (strcmp(argv[i], "--record") == 0)
+			options->recordPath = argv[++i];
+		else if (strcmp(argv[i], "--replay") == 0)
+			options->replayPath = argv[++i];
+	}
+}
+
+// Function that opens a log file and writes its header with the seed and the config the session is played with
+bool startRecording(InputRecorder* recorder, const char* path, Uint32 seed, const GameConfig* config)
+{
+	memset(recorder, 0, sizeof *recorder);
+
+	recorder->file = SDL_RWFromFile(path, "wb");
+	if (!recorder->file)
+	{
+		printf("Couldn't open %s for recording: %s\n", path, SDL_GetError());
+		return false;
+	}
+
+	Uint8 header[REPLAY_HEADER_SIZE];
+	memcpy(header, REPLAY_MAGIC, 4);
+	writeLittleEndian(header + 4, REPLAY_VERSION, 2);
+	writeLittleEndian(header + 6, TICK_RATE, 2);
+	writeLittleEndian(header + 8, seed, 4);
+
+	packGameConfig(config, header + REPLAY_CONFIG_OFFSET);
+	writeLittleEndian(header + REPLAY_TUNABLES_OFFSET, hashTunables(), 4);
+
+	SDL_RWwrite(recorder->file, header, 1, sizeof header);
+
+	return true;
+}
+
+// Record the input of one tick, a run is only written once the input changes
+void recordInput(InputRecorder* recorder, const PlayerInput* input)
+{
+	if (!recorder->file)
+		return;
+
+	Uint8 packed = packInput(input);
+
+	if (packed != recorder->current)
+	{
+		flushRun(recorder);
+		recorder->current = packed;
+	}
+
+	recorder->run++;
+	recorder->ticks++;
+}
+
+// Write the last run and the footer and close the file
+void stopRecording(InputRecorder* recorder, Uint32 stateHash)
+{
+	if (!recorder->file)
+		return;
+
+	flushRun(recorder);
+
+	Uint8 footer[13];
+	footer[0] = FOOTER_MARKER;
+	writeLittleEndian(footer + 1, recorder->ticks, 8);
+	writeLittleEndian(footer + 9, stateHash, 4);
+
+	SDL_RWwrite(recorder->file, footer, 1, sizeof footer);
+	SDL_RWclose(recorder->file);
+
+	recorder->file = NULL;
+}
+
+// Function that reads a whole log file into memory and checks its header. The config takes the values the session was recorded with,
+// except for the authored waves, which can't be stored in the file and have to be given again with "--waves"
+bool loadReplay(InputReplay* replay, const char* path, GameConfig* config)
+{
+	memset(replay, 0, sizeof *replay);
+
+	replay->data = (Uint8*)SDL_LoadFile(path, &replay->size);
+	if (!replay->data)
+	{
+		printf("Couldn't load replay %s: %s\n", path, SDL_GetError());
+		return false;
+	}
+
+	if (replay->size < 6 || memcmp(replay->data, REPLAY_MAGIC, 4) != 0)
+	{
+		printf("%s is not a replay file\n", path);
+		freeReplay(replay);
+		return false;
+	}
+
+	// Older files don't hold the config or the tunables, so there's no telling which game they were recorded in
+	int version = (int)readLittleEndian(replay->data + 4, 2);
+	if (version != REPLAY_VERSION || replay->size < REPLAY_HEADER_SIZE)
+	{
+		printf("%s is a version %d replay, this build plays version %d\n", path, version, REPLAY_VERSION);
+		freeReplay(replay);
+		return false;
+	}
+
+	// Inputs are per fixed tick, so a different tick rate would play out differently
+	if (readLittleEndian(replay->data + 6, 2) != TICK_RATE)
+	{
+		printf("%s was recorded at %d ticks per second, expected %d\n", path, (int)readLittleEndian(replay->data + 6, 2), TICK_RATE);
+		freeReplay(replay);
+		return false;
+	}
+
+	// The hash of the authored waves ends the packed config
+	Uint32 wavesHash = (Uint32)readLittleEndian(replay->data + REPLAY_TUNABLES_OFFSET - 4, 4);
+	if (wavesHash != hashConfigWaves(config))
+	{
+		if (wavesHash == 0)
+			printf("%s was recorded without authored waves, replay it without \"--waves\"\n", path);
+		else
+			printf("%s was recorded with other waves (hash %08x), replay it with the same \"--waves FILE\"\n", path, wavesHash);
+
+		freeReplay(replay);
+		return false;
+	}
+
+	// Tunables aren't part of the config, a dev build that changed them can't play a recording of the defaults and the other way around
+	Uint32 tunablesHash = (Uint32)readLittleEndian(replay->data + REPLAY_TUNABLES_OFFSET, 4);
+	if (tunablesHash != hashTunables())
+	{
+		printf("%s was recorded with other tunables (hash %08x, these are %08x), replay it with the same values\n", path, tunablesHash, hashTunables());
+		freeReplay(replay);
+		return false;
+	}
+
+	const Uint8* header = replay->data;
+
+	GameConfig recorded = *config;
+	unpackGameConfig(header + REPLAY_CONFIG_OFFSET, &recorded);
+
+	if (recorded.formationCols <= 0 || recorded.formationRows <= 0 || recorded.maxBullets <= 0 || recorded.maxParticles <= 0)
+	{
+		printf("%s has a broken config in its header\n", path);
+		freeReplay(replay);
+		return false;
+	}
+
+	// The command line may have asked for something else, the recording wins so it plays out the same
+	if (memcmp(&recorded, config, sizeof recorded) != 0)
+		printf("Replaying %s with the config it was recorded with\n", path);
+
+	*config = recorded;
+
+	replay->seed = (Uint32)readLittleEndian(header + 8, 4);
+	replay->pos = REPLAY_HEADER_SIZE;
+
+	return true;
+}
+
+// Get the input of the next tick. Returns false once the recording has ended
+bool nextReplayInput(InputReplay* replay, PlayerInput* input)
+{
+	if (!replay->data || replay->finished)
+		return false;
+
+	// Read the next run
+	while (replay->runLeft == 0)
+	{
+		if (replay->pos >= replay->size)
+		{
+			replay->finished = true;
+			return false;
+		}
+
+		Uint8 packed = replay->data[replay->pos++];
+
+		if (packed == FOOTER_MARKER)
+		{
+			if (replay->pos + 12 <= replay->size)
+			{
+				replay->hasFooter = true;
+				replay->expectedTicks = readLittleEndian(replay->data + replay->pos, 8);
+				replay->expectedHash = (Uint32)readLittleEndian(replay->data + replay->pos + 8, 4);
+			}
+
+			replay->finished = true;
+			return false;
+		}
+
+		Uint32 run = 0;
+		int shift = 0;
+		while (replay->pos < replay->size && shift < 32)
+		{
+			Uint8 byte = replay->data[replay->pos++];
+			run |= (Uint32)(byte & 0x7F) << shift;
+			shift += 7;
+
+			if (!(byte & 0x80))
+				break;
+		}
+
+		replay->current = packed;
+		replay->runLeft = run;
+	}
+
+	unpackInput(replay->current, input);
+
+	replay->runLeft--;
+	replay->ticks++;
+
+	return true;
+}
+
+// Function that compares the end of a replay with the end of the recorded session and prints the result
+bool checkReplayResult(const InputReplay* replay, Uint32 stateHash)
+{
+	if (!replay->hasFooter)
+	{
+		printf("Replay finished after %llu ticks, the recording has no footer to compare against\n", (unsigned long long)replay->ticks);
+		return true;
+	}
+
+	bool match = replay->ticks == replay->expectedTicks && stateHash == replay->expectedHash;
+
+	printf("Replay finished after %llu ticks, state hash %08x, recorded %08x: %s\n",
+		(unsigned long long)replay->ticks, stateHash, replay->expectedHash, match ? "match" : "DESYNC");
+
+	return match;
+}
+
+// Free the memory used by a replay
+void freeReplay(InputReplay* replay)
+{
+	SDL_free(replay->data);
+	memset(replay, 0, sizeof *replay);
+}
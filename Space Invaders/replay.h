@@ -0,0 +1,84 @@
+#pragma once
+
+// SDL libraries
+#include <SDL.h>
+
+// Game modules
+#include "game.h"
+
+// Helper libraries
+#include <stdbool.h>
+
+#pragma region Structs and defines
+
+// Bits of a packed input, used by recordings and by netplay
+#define INPUT_LEFT 0x01
+#define INPUT_RIGHT 0x02
+#define INPUT_SHOOT 0x04
+#define INPUT_BITS 3
+
+// Bytes of a config as recordings and netplay packets carry it, with the hash of the authored waves last
+#define PACKED_CONFIG_SIZE 48
+
+// Paths given with "--record FILE" and "--replay FILE", NULL if not given
+typedef struct ReplayOptions
+{
+	const char* recordPath;
+	const char* replayPath;
+} ReplayOptions;
+
+// Writes the input of every tick to a file as runs of identical inputs
+typedef struct InputRecorder
+{
+	SDL_RWops* file; // Open log file, NULL when not recording
+
+	Uint8 current; // Packed input of the current run
+	Uint32 run; // Amount of ticks in the current run
+	Uint64 ticks; // Amount of ticks recorded
+} InputRecorder;
+
+// Reads back a log written by an InputRecorder
+typedef struct InputReplay
+{
+	Uint8* data; // Whole log file, NULL when not replaying
+	size_t size, pos; // Size of the file and read position
+
+	Uint32 seed; // Seed the recorded session was started with
+
+	Uint8 current; // Packed input of the current run
+	Uint32 runLeft; // Ticks left in the current run
+	Uint64 ticks; // Amount of ticks replayed
+
+	bool finished; // True once every recorded tick has been replayed
+	bool hasFooter; // True if the recording was closed properly
+	Uint64 expectedTicks; // Amount of ticks in the recording
+	Uint32 expectedHash; // Hash of the game state at the end of the recording
+} InputReplay;
+
+#pragma endregion
+
+#pragma region Function declarations
+
+// Inputs packed into the low bits of a byte
+Uint8 packInput(const PlayerInput* input);
+void unpackInput(Uint8 packed, PlayerInput* input);
+
+// Config packed the same way on every machine, the authored waves only as their hash. Unpacking keeps the authored waves of the config
+void packGameConfig(const GameConfig* config, Uint8* out);
+void unpackGameConfig(const Uint8* in, GameConfig* config);
+
+// Command line
+void parseReplayOptions(int argc, char* argv[], ReplayOptions* options);
+
+// Recording
+bool startRecording(InputRecorder* recorder, const char* path, Uint32 seed, const GameConfig* config);
+void recordInput(InputRecorder* recorder, const PlayerInput* input);
+void stopRecording(InputRecorder* recorder, Uint32 stateHash);
+
+// Replaying. The config is changed to the one of the recording
+bool loadReplay(InputReplay* replay, const char* path, GameConfig* config);
+bool nextReplayInput(InputReplay* replay, PlayerInput* input);
+bool checkReplayResult(const InputReplay* replay, Uint32 stateHash);
+void freeReplay(InputReplay* replay);
+
+#pragma endregion
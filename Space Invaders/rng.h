@@ -0,0 +1,54 @@
+#pragma once
+
+// SDL libraries
+#include <SDL.h>
+
+// Standard libraries
+#include <math.h>
+
+#pragma region Structs
+
+// State of a PCG32 pseudo-random number generator
+typedef struct Rng
+{
+	Uint64 state;
+} Rng;
+
+#pragma endregion
+
+#pragma region Inline functions
+
+// Get the next 32 random bits
+static inline Uint32 nextRandom(Rng* rng)
+{
+	Uint64 old = rng->state;
+	rng->state = old * 6364136223846793005ULL + 1442695040888963407ULL;
+
+	Uint32 xorshifted = (Uint32)(((old >> 18u) ^ old) >> 27u);
+	Uint32 rot = (Uint32)(old >> 59u);
+
+	return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+}
+
+// Seed the generator, every seed gives a different sequence
+static inline void seedRandom(Rng* rng, Uint64 seed)
+{
+	rng->state = 0;
+	nextRandom(rng);
+	rng->state += seed;
+	nextRandom(rng);
+}
+
+// Get a random float in the range [0, 1)
+static inline float nextRandomFloat(Rng* rng)
+{
+	return (float)(nextRandom(rng) >> 8) * (1.0f / 16777216.0f);
+}
+
+// Get an exponentially distributed waiting time for an event that happens rate times per second on average
+static inline float nextRandomWait(Rng* rng, float rate)
+{
+	return -logf(1.0f - nextRandomFloat(rng)) / rate;
+}
+
+#pragma endregion
@@ -0,0 +1,384 @@
+// fileno and fsync are POSIX, strict C builds only declare them when asked to
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "scores.h"
+
+// Game modules
+#include "bytes.h"
+
+// Standard libraries
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+// File layout, every integer little-endian:
+//   header:  "SIHS", version (u16), entry count (u16)
+//   totals:  sessions (u32), games played (u32), total score (u64), best wave (u32)
+//   entries: score (u32), wave (u32), time (u64), best first
+//   footer:  FNV-1a hash (u32) of everything before it, so a damaged file is never loaded
+#define SCORES_MAGIC "SIHS"
+#define SCORES_VERSION 1
+#define SCORES_HEADER_SIZE 8
+#define SCORES_TOTALS_SIZE 20
+#define SCORES_ENTRY_SIZE 16
+#define SCORES_FILE_SIZE (SCORES_HEADER_SIZE + SCORES_TOTALS_SIZE + MAX_HIGH_SCORES * SCORES_ENTRY_SIZE + 4)
+
+// Name of the file in the preference folder, and what is added to it for the file that is written before replacing it
+#define SCORES_FILE_NAME "scores.dat"
+#define TEMP_SUFFIX ".tmp"
+
+#pragma region Globals
+
+static ScoreTable table;
+
+// Whether the table changed since it was last handed to the writer
+static bool tableChanged = false;
+
+// Where the table is saved, and where it's written first. NULL when there is nowhere to save it
+static char* scoresPath = NULL;
+static char* tempPath = NULL;
+
+// Thread that writes the file, and the newest contents it hasn't written yet. Contents that are replaced before being written are skipped
+static SDL_Thread* writer = NULL;
+static SDL_mutex* writeLock = NULL;
+static SDL_cond* writeWanted = NULL;
+
+static Uint8 pendingFile[SCORES_FILE_SIZE];
+static size_t pendingSize = 0;
+static bool writePending = false;
+static bool writerStopping = false;
+
+#pragma endregion
+
+#pragma region Helpers
+
+// Function that lays out a table as the file, returns the size of the file
+static size_t writeScoreTable(const ScoreTable* scores, Uint8* out)
+{
+	Uint8* at = out;
+
+	memcpy(at, SCORES_MAGIC, 4);
+	writeLittleEndian(at + 4, SCORES_VERSION, 2);
+	writeLittleEndian(at + 6, (Uint64)scores->count, 2);
+	at += SCORES_HEADER_SIZE;
+
+	writeLittleEndian(at, scores->sessions, 4);
+	writeLittleEndian(at + 4, scores->gamesPlayed, 4);
+	writeLittleEndian(at + 8, scores->totalScore, 8);
+	writeLittleEndian(at + 16, (Uint32)scores->bestWave, 4);
+	at += SCORES_TOTALS_SIZE;
+
+	for (int i = 0; i < scores->count; i++)
+	{
+		writeLittleEndian(at, (Uint32)scores->entries[i].score, 4);
+		writeLittleEndian(at + 4, (Uint32)scores->entries[i].wave, 4);
+		writeLittleEndian(at + 8, (Uint64)scores->entries[i].time, 8);
+		at += SCORES_ENTRY_SIZE;
+	}
+
+	writeLittleEndian(at, hashBytes(FNV_OFFSET_BASIS, out, (size_t)(at - out)), 4);
+	at += 4;
+
+	return (size_t)(at - out);
+}
+
+// Function that reads a table from the contents of its file. Returns false if the file is damaged or from another version
+static bool readScoreTable(const Uint8* data, size_t size, ScoreTable* scores)
+{
+	if (size < SCORES_HEADER_SIZE + SCORES_TOTALS_SIZE + 4 || memcmp(data, SCORES_MAGIC, 4) != 0)
+		return false;
+
+	int count = (int)readLittleEndian(data + 6, 2);
+
+	size_t expected = SCORES_HEADER_SIZE + SCORES_TOTALS_SIZE + (size_t)count * SCORES_ENTRY_SIZE + 4;
+	if (readLittleEndian(data + 4, 2) != SCORES_VERSION || count > MAX_HIGH_SCORES || size != expected)
+		return false;
+
+	if (readLittleEndian(data + size - 4, 4) != hashBytes(FNV_OFFSET_BASIS, data, size - 4))
+		return false;
+
+	const Uint8* at = data + SCORES_HEADER_SIZE;
+
+	memset(scores, 0, sizeof *scores);
+	scores->count = count;
+	scores->sessions = (Uint32)readLittleEndian(at, 4);
+	scores->gamesPlayed = (Uint32)readLittleEndian(at + 4, 4);
+	scores->totalScore = readLittleEndian(at + 8, 8);
+	scores->bestWave = (int)(Uint32)readLittleEndian(at + 16, 4);
+	at += SCORES_TOTALS_SIZE;
+
+	for (int i = 0; i < count; i++)
+	{
+		scores->entries[i].score = (int)(Uint32)readLittleEndian(at, 4);
+		scores->entries[i].wave = (int)(Uint32)readLittleEndian(at + 4, 4);
+		scores->entries[i].time = (Sint64)readLittleEndian(at + 8, 8);
+		at += SCORES_ENTRY_SIZE;
+	}
+
+	return true;
+}
+
+// Function that writes the file next to the table and moves it over the table once it's on the disk.
+// A crash at any point leaves either the old or the new table whole
+static bool writeScoresFile(const Uint8* data, size_t size)
+{
+#ifdef _WIN32
+	// Paths are UTF-8, Windows only takes those as UTF-16
+	wchar_t* wideTemp = (wchar_t*)SDL_iconv_utf8_ucs2(tempPath);
+	wchar_t* widePath = (wchar_t*)SDL_iconv_utf8_ucs2(scoresPath);
+
+	FILE* file = wideTemp && widePath ? _wfopen(wideTemp, L"wb") : NULL;
+#else
+	FILE* file = fopen(tempPath, "wb");
+#endif
+
+	bool success = file != NULL;
+
+	if (file)
+	{
+		success = fwrite(data, 1, size, file) == size && fflush(file) == 0;
+
+#ifdef _WIN32
+		success = success && _commit(_fileno(file)) == 0;
+#else
+		success = success && fsync(fileno(file)) == 0;
+#endif
+
+		success = fclose(file) == 0 && success;
+	}
+
+#ifdef _WIN32
+	success = success && MoveFileExW(wideTemp, widePath, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+
+	SDL_free(wideTemp);
+	SDL_free(widePath);
+#else
+	success = success && rename(tempPath, scoresPath) == 0;
+#endif
+
+	if (!success)
+		printf("Couldn't save the high scores to %s\n", scoresPath);
+
+	return success;
+}
+
+// Function that runs on the writer thread, it writes the newest contents it was given until it's stopped
+static int scoreWriterThread(void* data)
+{
+	Uint8 file[SCORES_FILE_SIZE];
+
+	SDL_LockMutex(writeLock);
+
+	for (;;)
+	{
+		while (!writePending && !writerStopping)
+			SDL_CondWait(writeWanted, writeLock);
+
+		// A write that was asked for before stopping is still finished
+		if (!writePending)
+			break;
+
+		size_t size = pendingSize;
+		memcpy(file, pendingFile, size);
+		writePending = false;
+
+		SDL_UnlockMutex(writeLock);
+		writeScoresFile(file, size);
+		SDL_LockMutex(writeLock);
+	}
+
+	SDL_UnlockMutex(writeLock);
+
+	return 0;
+}
+
+// Function that hands the table to the writer thread, or writes it right away if there is no writer thread
+static void saveScores(void)
+{
+	tableChanged = false;
+
+	if (!scoresPath)
+		return;
+
+	if (!writer)
+	{
+		Uint8 file[SCORES_FILE_SIZE];
+		size_t size = writeScoreTable(&table, file);
+
+		writeScoresFile(file, size);
+		return;
+	}
+
+	SDL_LockMutex(writeLock);
+	pendingSize = writeScoreTable(&table, pendingFile);
+	writePending = true;
+	SDL_UnlockMutex(writeLock);
+
+	SDL_CondSignal(writeWanted);
+}
+
+#pragma endregion
+
+// Function that picks up "--scores FILE" from the command line
+void parseScoreOptions(int argc, char* argv[], ScoreOptions* options)
+{
+	options->path = NULL;
+
+	for (int i = 1; i < argc - 1; i++)
+	{
+		if (strcmp(argv[i], "--scores") == 0)
+			options->path = argv[++i];
+	}
+}
+
+// Function that loads the table with a single read and starts the writer thread. Without a table or a place to save it, the game starts a new one
+bool initScores(const ScoreOptions* options)
+{
+	memset(&table, 0, sizeof table);
+
+	if (options->path)
+	{
+		scoresPath = SDL_strdup(options->path);
+	}
+	else
+	{
+		char* folder = SDL_GetPrefPath(NULL, "Space Invaders");
+		if (folder)
+		{
+			size_t length = strlen(folder) + sizeof SCORES_FILE_NAME;
+			scoresPath = (char*)SDL_malloc(length);
+			if (scoresPath)
+				snprintf(scoresPath, length, "%s%s", folder, SCORES_FILE_NAME);
+
+			SDL_free(folder);
+		}
+	}
+
+	if (!scoresPath)
+	{
+		printf("No place to save the high scores: %s\n", SDL_GetError());
+		return true;
+	}
+
+	size_t tempLength = strlen(scoresPath) + sizeof TEMP_SUFFIX;
+	tempPath = (char*)SDL_malloc(tempLength);
+	if (!tempPath)
+	{
+		printf("Couldn't allocate the high score paths\n");
+		return false;
+	}
+	snprintf(tempPath, tempLength, "%s%s", scoresPath, TEMP_SUFFIX);
+
+	// A missing file is a first start, a damaged one is replaced with the next save
+	size_t size = 0;
+	Uint8* data = (Uint8*)SDL_LoadFile(scoresPath, &size);
+
+	if (data && !readScoreTable(data, size, &table))
+	{
+		printf("High scores in %s are damaged, starting a new table\n", scoresPath);
+		memset(&table, 0, sizeof table);
+	}
+
+	SDL_free(data);
+
+	table.sessions++;
+	tableChanged = true;
+
+	// Without a writer thread the table is written on the main thread instead
+	writeLock = SDL_CreateMutex();
+	writeWanted = SDL_CreateCond();
+	writerStopping = false;
+	writePending = false;
+
+	if (writeLock && writeWanted)
+		writer = SDL_CreateThread(scoreWriterThread, "Score writer", NULL);
+
+	if (!writer)
+		printf("Couldn't start the high score writer: %s\n", SDL_GetError());
+
+	return true;
+}
+
+// Function that saves the table if it changed and waits for the writer thread to finish
+void quitScores(void)
+{
+	if (tableChanged)
+		saveScores();
+
+	if (writer)
+	{
+		SDL_LockMutex(writeLock);
+		writerStopping = true;
+		SDL_UnlockMutex(writeLock);
+
+		SDL_CondSignal(writeWanted);
+		SDL_WaitThread(writer, NULL);
+		writer = NULL;
+	}
+
+	SDL_DestroyCond(writeWanted);
+	SDL_DestroyMutex(writeLock);
+	writeWanted = NULL;
+	writeLock = NULL;
+
+	SDL_free(scoresPath);
+	SDL_free(tempPath);
+	scoresPath = NULL;
+	tempPath = NULL;
+}
+
+// Function that adds the game the world finished to the totals and, if it's good enough, to the table
+void recordFinishedGame(World* world, bool record)
+{
+	if (!world->gameFinished)
+		return;
+
+	world->gameFinished = false;
+
+	if (!record)
+		return;
+
+	const GameResult* result = &world->lastGame;
+
+	table.gamesPlayed++;
+	table.totalScore += (Uint64)max(result->score, 0);
+	table.bestWave = max(table.bestWave, result->wave);
+
+	// Games with the same score keep the order they were played in
+	int rank = 0;
+	while (rank < table.count && table.entries[rank].score >= result->score)
+		rank++;
+
+	if (rank < MAX_HIGH_SCORES)
+	{
+		int moved = min(table.count, MAX_HIGH_SCORES - 1) - rank;
+		if (moved > 0)
+			memmove(&table.entries[rank + 1], &table.entries[rank], sizeof(HighScore) * (size_t)moved);
+
+		table.entries[rank] = (HighScore){ .score = result->score, .wave = result->wave, .time = (Sint64)time(NULL) };
+		table.count = min(table.count + 1, MAX_HIGH_SCORES);
+	}
+
+	saveScores();
+}
+
+// Function for getting the best score of every session
+int getBestScore(void)
+{
+	return table.count > 0 ? table.entries[0].score : 0;
+}
+
+const ScoreTable* getScoreTable(void)
+{
+	return &table;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+// SDL libraries
+#include <SDL.h>
+
+// Game modules
+#include "game.h"
+
+// Helper libraries
+#include <stdbool.h>
+
+#pragma region Structs and defines
+
+// Amount of games kept in the table
+#define MAX_HIGH_SCORES 10
+
+// File given with "--scores FILE", NULL for scores.dat in the preference folder of the user
+typedef struct ScoreOptions
+{
+	const char* path;
+} ScoreOptions;
+
+// A game in the table
+typedef struct HighScore
+{
+	int score;
+	int wave; // Wave the game ended on
+	Sint64 time; // When it ended, in seconds since 1970
+} HighScore;
+
+// Best games, best first, and totals over every session
+typedef struct ScoreTable
+{
+	HighScore entries[MAX_HIGH_SCORES];
+	int count;
+
+	Uint32 sessions; // Amount of times the game was started
+	Uint32 gamesPlayed;
+	Uint64 totalScore;
+	int bestWave;
+} ScoreTable;
+
+#pragma endregion
+
+#pragma region Function declarations
+
+// Parse score options from the command line
+void parseScoreOptions(int argc, char* argv[], ScoreOptions* options);
+
+// Initialization and exit. The table is loaded with a single read, exit waits for the last write to finish
+bool initScores(const ScoreOptions* options);
+void quitScores(void);
+
+// Add the game the world has finished, if there is one, and save the table on the writer thread.
+// Games are only added if record is true, but the result is always taken so it isn't added later
+void recordFinishedGame(World* world, bool record);
+
+// Best score of every session, 0 if none has been played
+int getBestScore(void);
+const ScoreTable* getScoreTable(void);
+
+#pragma endregion
@@ -0,0 +1,210 @@
+#include "sprites.h"
+
+// SDL libraries
+#include <SDL_image.h>
+
+// Standard libraries
+#include <stdlib.h>
+#include <stdio.h>
+
+// Size of the generated solid sprite and the gap between sprites, so nearest sampling never bleeds
+#define SOLID_SPRITE_SIZE 4
+#define SPRITE_PADDING 1
+
+// Function that loads every sprite and packs them side by side into a single surface. Doesn't use the renderer, so it can run on any thread
+bool createSpriteSheet(SpriteSheet* sheet, const char* const files[SPRITE_COUNT])
+{
+	SDL_Surface* surfaces[SPRITE_COUNT] = { NULL };
+	bool success = true;
+
+	SDL_zerop(sheet);
+
+	// Load every sprite as RGBA and lay them out in one row
+	int width = 0, height = 0;
+	for (int i = 0; i < SPRITE_COUNT; i++)
+	{
+		if (files[i])
+		{
+			SDL_Surface* loaded = IMG_Load(files[i]);
+			if (!loaded)
+			{
+				printf("Couldn't load sprite %s: %s\n", files[i], IMG_GetError());
+				success = false;
+				continue;
+			}
+
+			surfaces[i] = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0);
+			SDL_FreeSurface(loaded);
+		}
+		else
+		{
+			// Solid white sprite, tinted with the vertex color when drawn
+			surfaces[i] = SDL_CreateRGBSurfaceWithFormat(0, SOLID_SPRITE_SIZE, SOLID_SPRITE_SIZE, 32, SDL_PIXELFORMAT_RGBA32);
+			if (surfaces[i])
+				SDL_memset(surfaces[i]->pixels, 0xFF, (size_t)surfaces[i]->pitch * (size_t)surfaces[i]->h);
+		}
+
+		if (!surfaces[i])
+		{
+			success = false;
+			continue;
+		}
+
+		sheet->rects[i] = (SDL_Rect){ .x = width, .y = 0, .w = surfaces[i]->w, .h = surfaces[i]->h };
+
+		width += surfaces[i]->w + SPRITE_PADDING;
+		height = max(height, surfaces[i]->h);
+	}
+
+	// Copy the sprites into the sheet
+	if (success)
+		sheet->surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_RGBA32);
+
+	if (sheet->surface)
+	{
+		for (int i = 0; i < SPRITE_COUNT; i++)
+		{
+			SDL_SetSurfaceBlendMode(surfaces[i], SDL_BLENDMODE_NONE);
+			SDL_BlitSurface(surfaces[i], NULL, sheet->surface, &sheet->rects[i]);
+		}
+	}
+	else
+	{
+		printf("Couldn't create sprite sheet: %s\n", SDL_GetError());
+		success = false;
+	}
+
+	for (int i = 0; i < SPRITE_COUNT; i++)
+		SDL_FreeSurface(surfaces[i]);
+
+	return success;
+}
+
+// Free the surface of a sprite sheet
+void freeSpriteSheet(SpriteSheet* sheet)
+{
+	SDL_FreeSurface(sheet->surface);
+	sheet->surface = NULL;
+}
+
+// Function that uploads a sprite sheet as the texture of the sprite atlas
+bool createSpriteAtlas(SpriteAtlas* atlas, SDL_Renderer* renderer, const SpriteSheet* sheet)
+{
+	SDL_zerop(atlas);
+
+	float width = (float)sheet->surface->w;
+	float height = (float)sheet->surface->h;
+
+	for (int i = 0; i < SPRITE_COUNT; i++)
+	{
+		atlas->uv[i] = (SDL_FRect){
+			.x = (float)sheet->rects[i].x / width,
+			.y = (float)sheet->rects[i].y / height,
+			.w = (float)sheet->rects[i].w / width,
+			.h = (float)sheet->rects[i].h / height
+		};
+
+		// A sprite wider than it's high is a strip of square frames
+		atlas->frames[i] = sheet->rects[i].h > 0 ? max(1, sheet->rects[i].w / sheet->rects[i].h) : 1;
+	}
+
+	atlas->texture = SDL_CreateTextureFromSurface(renderer, sheet->surface);
+	if (!atlas->texture)
+	{
+		printf("Couldn't create sprite atlas: %s\n", SDL_GetError());
+		return false;
+	}
+
+	SDL_SetTextureBlendMode(atlas->texture, SDL_BLENDMODE_BLEND);
+	return true;
+}
+
+// Free the texture used by the sprite atlas
+void freeSpriteAtlas(SpriteAtlas* atlas)
+{
+	SDL_DestroyTexture(atlas->texture);
+	atlas->texture = NULL;
+}
+
+// Function that allocates a sprite batch and fills in its index pattern
+bool createSpriteBatch(SpriteBatch* batch, int capacity)
+{
+	batch->count = 0;
+	batch->capacity = capacity;
+	batch->vertices = (SDL_Vertex*)malloc(sizeof(SDL_Vertex) * 4 * (size_t)capacity);
+	batch->indices = (int*)malloc(sizeof(int) * 6 * (size_t)capacity);
+
+	if (!batch->vertices || !batch->indices)
+	{
+		freeSpriteBatch(batch);
+		return false;
+	}
+
+	// Two triangles per sprite, the pattern never changes
+	for (int i = 0; i < capacity; i++)
+	{
+		int* index = &batch->indices[i * 6];
+		int base = i * 4;
+
+		index[0] = base; index[1] = base + 1; index[2] = base + 2;
+		index[3] = base; index[4] = base + 2; index[5] = base + 3;
+	}
+
+	return true;
+}
+
+// Free the memory used by a sprite batch
+void freeSpriteBatch(SpriteBatch* batch)
+{
+	free(batch->vertices);
+	free(batch->indices);
+
+	batch->vertices = NULL;
+	batch->indices = NULL;
+	batch->count = 0;
+	batch->capacity = 0;
+}
+
+// Add a sprite to the batch, sprites beyond the capacity of the batch are dropped
+void addSprite(SpriteBatch* batch, const SpriteAtlas* atlas, SpriteId sprite, float px, float py, float w, float h, SDL_Color color)
+{
+	addSpriteFrame(batch, atlas, sprite, 0, px, py, w, h, color);
+}
+
+// Add a single animation frame of a sprite to the batch, frames past the last one show the last one
+void addSpriteFrame(SpriteBatch* batch, const SpriteAtlas* atlas, SpriteId sprite, int frame, float px, float py, float w, float h, SDL_Color color)
+{
+	if (batch->count >= batch->capacity)
+		return;
+
+	const SDL_FRect* uv = &atlas->uv[sprite];
+
+	// An atlas that failed to load has no frames, its sprites are drawn untextured
+	int frames = max(1, atlas->frames[sprite]);
+	if (frame >= frames)
+		frame = frames - 1;
+
+	float frameWidth = uv->w / (float)frames;
+
+	float x0 = px, y0 = py;
+	float x1 = px + w, y1 = py + h;
+	float u0 = uv->x + frameWidth * (float)frame, v0 = uv->y;
+	float u1 = u0 + frameWidth, v1 = uv->y + uv->h;
+
+	SDL_Vertex* quad = &batch->vertices[batch->count * 4];
+	quad[0] = (SDL_Vertex){ { x0, y0 }, color, { u0, v0 } };
+	quad[1] = (SDL_Vertex){ { x1, y0 }, color, { u1, v0 } };
+	quad[2] = (SDL_Vertex){ { x1, y1 }, color, { u1, v1 } };
+	quad[3] = (SDL_Vertex){ { x0, y1 }, color, { u0, v1 } };
+
+	batch->count++;
+}
+
+// Submit every sprite of the batch with a single geometry call
+void flushSpriteBatch(SpriteBatch* batch, SDL_Renderer* renderer, const SpriteAtlas* atlas)
+{
+	if (batch->count > 0)
+		SDL_RenderGeometry(renderer, atlas->texture, batch->vertices, batch->count * 4, batch->indices, batch->count * 6);
+
+	batch->count = 0;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+// SDL libraries
+#include <SDL.h>
+
+// Helper libraries
+#include <stdbool.h>
+
+#pragma region Structs and ENUMs
+
+// Every sprite packed into the sprite atlas
+typedef enum SpriteId { SPRITE_PLAYER, SPRITE_ENEMY, SPRITE_BULLET, SPRITE_BULLET_EXPLOSION, SPRITE_SHIP_EXPLOSION, SPRITE_COUNT } SpriteId;
+
+// Every sprite packed side by side into one RGBA surface, before being uploaded
+typedef struct SpriteSheet
+{
+	SDL_Surface* surface;
+	SDL_Rect rects[SPRITE_COUNT]; // Where each sprite is in the surface, in pixels
+} SpriteSheet;
+
+typedef struct SpriteAtlas
+{
+	SDL_Texture* texture; // Texture containing every sprite
+	SDL_FRect uv[SPRITE_COUNT]; // Texture coordinates of each sprite, from 0 to 1
+	int frames[SPRITE_COUNT]; // Animation frames of each sprite, laid out left to right as squares
+} SpriteAtlas;
+
+typedef struct SpriteBatch
+{
+	SDL_Vertex* vertices; // Four vertices per sprite
+	int* indices; // Six indices per sprite, filled once when the batch is created
+
+	int count; // Amount of sprites added since the last flush
+	int capacity; // Maximum amount of sprites per flush
+} SpriteBatch;
+
+#pragma endregion
+
+#pragma region Function declarations
+
+// Sheet creation, files are indexed by SpriteId and a NULL file becomes a solid white sprite
+bool createSpriteSheet(SpriteSheet* sheet, const char* const files[SPRITE_COUNT]);
+void freeSpriteSheet(SpriteSheet* sheet);
+
+// Atlas creation from a sheet
+bool createSpriteAtlas(SpriteAtlas* atlas, SDL_Renderer* renderer, const SpriteSheet* sheet);
+void freeSpriteAtlas(SpriteAtlas* atlas);
+
+// Batching
+bool createSpriteBatch(SpriteBatch* batch, int capacity);
+void freeSpriteBatch(SpriteBatch* batch);
+void addSprite(SpriteBatch* batch, const SpriteAtlas* atlas, SpriteId sprite, float px, float py, float w, float h, SDL_Color color);
+void addSpriteFrame(SpriteBatch* batch, const SpriteAtlas* atlas, SpriteId sprite, int frame, float px, float py, float w, float h, SDL_Color color);
+void flushSpriteBatch(SpriteBatch* batch, SDL_Renderer* renderer, const SpriteAtlas* atlas);
+
+#pragma endregion
@@ -0,0 +1,385 @@
+#include "telemetry.h"
+
+// Game modules
+#include "kernels.h"
+
+// Standard libraries
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+// Most tick and frame times kept for the percentiles of an interval, the counts go on past it
+#define MAX_INTERVAL_SAMPLES 65536
+
+#pragma region Structs and ENUMs
+
+typedef enum RecordType { RECORD_TICK, RECORD_FRAME } RecordType;
+
+// Entry of the ring, filled on the main thread and read on the writer thread
+typedef struct TelemetryRecord
+{
+	Uint8 type;
+	bool gameOver; // Frame: a game ended during it
+	Uint16 dropped; // Frame: frames the render thread never took
+	Uint32 duration; // Length of the tick or the frame, in microseconds
+
+	Uint32 shots, kills; // Frame: player shots and enemy kills during it
+	int wave; // Frame: wave at its end
+	int score; // Frame: score of the game that ended, if one did
+} TelemetryRecord;
+
+// Frames and ticks of the current summary, only touched by the writer thread
+typedef struct TelemetryInterval
+{
+	Uint32 frames, dropped, ticks;
+	Uint32 shots, kills;
+
+	Uint32* frameTimes;
+	Uint32* tickTimes;
+	int frameSamples, tickSamples;
+} TelemetryInterval;
+
+#pragma endregion
+
+#pragma region Globals
+
+static bool telemetryEnabled = false;
+
+// Ring with a single writer and a single reader. Each side only moves its own end, after the records it covers are in place
+static TelemetryRecord ring[TELEMETRY_RING_SIZE];
+static SDL_atomic_t ringHead; // Next record the main thread fills
+static SDL_atomic_t ringTail; // Next record the writer reads
+static SDL_atomic_t lostRecords;
+
+static SDL_Thread* writer = NULL;
+static SDL_atomic_t writerStopping;
+static SDL_sem* writerWake = NULL; // Posted to stop the writer without waiting out its poll
+
+static FILE* file = NULL;
+static Uint64 startCounter = 0;
+static Uint64 intervalCounts = 0; // Length of an interval, in performance counter units
+
+// Everything below is only touched by the writer thread
+static TelemetryInterval interval;
+static Uint64 nextSummary = 0;
+
+// Wave being played, and what happened during it so far
+static int currentWave = 0;
+static Uint32 waveShots = 0, waveKills = 0;
+static Uint64 waveStart = 0;
+
+// Totals of the session
+static Uint64 totalFrames = 0, totalDropped = 0, totalTicks = 0;
+static Uint32 totalGames = 0;
+
+#pragma endregion
+
+#pragma region Helpers
+
+// Seconds since the start of the session
+static double getSessionTime(Uint64 counter)
+{
+	return (double)(counter - startCounter) / (double)SDL_GetPerformanceFrequency();
+}
+
+// Add a record to the ring, or count it as lost if the writer has fallen behind
+static void pushRecord(const TelemetryRecord* record)
+{
+	unsigned int head = (unsigned int)SDL_AtomicGet(&ringHead);
+	unsigned int tail = (unsigned int)SDL_AtomicGet(&ringTail);
+
+	if (head - tail >= TELEMETRY_RING_SIZE)
+	{
+		SDL_AtomicAdd(&lostRecords, 1);
+		return;
+	}
+
+	ring[head & (TELEMETRY_RING_SIZE - 1)] = *record;
+
+	// Published only once the record is written
+	SDL_AtomicSet(&ringHead, (int)(head + 1));
+}
+
+// Helper function for sorting samples
+static int compareSamples(const void* a, const void* b)
+{
+	Uint32 x = *(const Uint32*)a;
+	Uint32 y = *(const Uint32*)b;
+
+	return (x > y) - (x < y);
+}
+
+// Function that writes the median, p99 and max of a set of samples in the given unit, sorting them
+static void writePercentiles(const char* name, Uint32* samples, int count, double unit)
+{
+	if (count == 0)
+	{
+		fprintf(file, ",\"%s\":null", name);
+		return;
+	}
+
+	qsort(samples, (size_t)count, sizeof(Uint32), compareSamples);
+
+	fprintf(file, ",\"%s\":{\"p50\":%.3f,\"p99\":%.3f,\"max\":%.3f}", name,
+		samples[(count - 1) / 2] / unit, samples[(count - 1) * 99 / 100] / unit, samples[count - 1] / unit);
+}
+
+// Function that writes the line of a wave once the next one has started
+static void writeWave(Uint64 now)
+{
+	fprintf(file, "{\"type\":\"wave\",\"time\":%.3f,\"wave\":%d,\"seconds\":%.3f,\"shots\":%u,\"kills\":%u}\n",
+		getSessionTime(now), currentWave, (double)(now - waveStart) / (double)SDL_GetPerformanceFrequency(), waveShots, waveKills);
+}
+
+// Function that adds a record to the current interval, and writes the lines of games and waves that ended
+static void addRecord(const TelemetryRecord* record, Uint64 now)
+{
+	if (record->type == RECORD_TICK)
+	{
+		interval.ticks++;
+		if (interval.tickSamples < MAX_INTERVAL_SAMPLES)
+			interval.tickTimes[interval.tickSamples++] = record->duration;
+		return;
+	}
+
+	interval.frames++;
+	interval.dropped += record->dropped;
+	interval.shots += record->shots;
+	interval.kills += record->kills;
+	if (interval.frameSamples < MAX_INTERVAL_SAMPLES)
+		interval.frameTimes[interval.frameSamples++] = record->duration;
+
+	// The last kill of a wave happens in the same tick as the start of the next, so it still counts for the wave before
+	waveShots += record->shots;
+	waveKills += record->kills;
+
+	if (record->wave != currentWave)
+	{
+		if (currentWave > 0)
+			writeWave(now);
+
+		currentWave = record->wave;
+		waveShots = 0;
+		waveKills = 0;
+		waveStart = now;
+	}
+
+	if (record->gameOver)
+	{
+		fprintf(file, "{\"type\":\"game\",\"time\":%.3f,\"score\":%d,\"wave\":%d}\n", getSessionTime(now), record->score, record->wave);
+		totalGames++;
+	}
+}
+
+// Function that writes the summary of the current interval and starts the next
+static void writeSummary(Uint64 now)
+{
+	fprintf(file, "{\"type\":\"interval\",\"time\":%.3f,\"frames\":%u,\"dropped\":%u,\"ticks\":%u", getSessionTime(now),
+		interval.frames, interval.dropped, interval.ticks);
+
+	writePercentiles("frame_ms", interval.frameTimes, interval.frameSamples, 1000.0);
+	writePercentiles("tick_us", interval.tickTimes, interval.tickSamples, 1.0);
+
+	fprintf(file, ",\"shots\":%u,\"kills\":%u,\"wave\":%d,\"lost\":%d}\n", interval.shots, interval.kills, currentWave, SDL_AtomicGet(&lostRecords));
+
+	totalFrames += interval.frames;
+	totalDropped += interval.dropped;
+	totalTicks += interval.ticks;
+
+	interval.frames = interval.dropped = interval.ticks = 0;
+	interval.shots = interval.kills = 0;
+	interval.frameSamples = interval.tickSamples = 0;
+
+	nextSummary = now + intervalCounts;
+}
+
+// Function that moves every record in the ring into the current interval
+static void drainRing(Uint64 now)
+{
+	unsigned int tail = (unsigned int)SDL_AtomicGet(&ringTail);
+	unsigned int head = (unsigned int)SDL_AtomicGet(&ringHead);
+
+	for (; tail != head; tail++)
+		addRecord(&ring[tail & (TELEMETRY_RING_SIZE - 1)], now);
+
+	// The records can be overwritten once the tail has moved past them
+	SDL_AtomicSet(&ringTail, (int)tail);
+}
+
+// Function that runs on the writer thread, it empties the ring every poll and writes a summary every interval
+static int telemetryThread(void* data)
+{
+	while (!SDL_AtomicGet(&writerStopping))
+	{
+		SDL_SemWaitTimeout(writerWake, TELEMETRY_POLL_TIME);
+
+		Uint64 now = SDL_GetPerformanceCounter();
+		drainRing(now);
+
+		if (now >= nextSummary)
+		{
+			writeSummary(now);
+			fflush(file);
+		}
+	}
+
+	// Whatever came in since the last poll, then the totals of the session
+	Uint64 now = SDL_GetPerformanceCounter();
+	drainRing(now);
+	writeSummary(now);
+
+	if (currentWave > 0)
+		writeWave(now);
+
+	fprintf(file, "{\"type\":\"end\",\"time\":%.3f,\"frames\":%llu,\"dropped\":%llu,\"ticks\":%llu,\"games\":%u,\"lost\":%d}\n",
+		getSessionTime(now), (unsigned long long)totalFrames, (unsigned long long)totalDropped, (unsigned long long)totalTicks,
+		totalGames, SDL_AtomicGet(&lostRecords));
+
+	return 0;
+}
+
+#pragma endregion
+
+// Function that picks up "--telemetry FILE" and "--telemetry-interval N" from the command line
+void parseTelemetryOptions(int argc, char* argv[], TelemetryOptions* options)
+{
+	options->path = NULL;
+	options->interval = DEFAULT_TELEMETRY_INTERVAL;
+
+	for (int i = 1; i < argc - 1; i++)
+	{
+		if (strcmp(argv[i], "--telemetry") == 0)
+			options->path = argv[++i];
+		else if (strcmp(argv[i], "--telemetry-interval") == 0)
+			options->interval = atoi(argv[++i]);
+	}
+
+	if (options->interval < 1)
+		options->interval = DEFAULT_TELEMETRY_INTERVAL;
+}
+
+// Function that opens the telemetry file, writes the start of the session and starts the writer thread
+bool initTelemetry(const TelemetryOptions* options)
+{
+	telemetryEnabled = false;
+
+	if (!options->path)
+		return true;
+
+	// Sessions are added to the end, so a kiosk keeps a single file
+	file = fopen(options->path, "a");
+	if (!file)
+	{
+		printf("Couldn't open %s for the telemetry\n", options->path);
+		return false;
+	}
+
+	interval = (TelemetryInterval){
+		.frameTimes = (Uint32*)malloc(sizeof(Uint32) * MAX_INTERVAL_SAMPLES),
+		.tickTimes = (Uint32*)malloc(sizeof(Uint32) * MAX_INTERVAL_SAMPLES),
+	};
+
+	if (!interval.frameTimes || !interval.tickTimes)
+	{
+		printf("Couldn't allocate the telemetry\n");
+		quitTelemetry();
+		return false;
+	}
+
+	startCounter = SDL_GetPerformanceCounter();
+	intervalCounts = SDL_GetPerformanceFrequency() * (Uint64)options->interval;
+	nextSummary = startCounter + intervalCounts;
+
+	currentWave = 0;
+	totalFrames = totalDropped = totalTicks = 0;
+	totalGames = 0;
+
+	fprintf(file, "{\"type\":\"session\",\"start\":%lld,\"tick_rate\":%d,\"interval\":%d,\"simd\":\"%s\"}\n",
+		(long long)time(NULL), TICK_RATE, options->interval, getKernelLevelName(getKernelLevel()));
+	fflush(file);
+
+	SDL_AtomicSet(&ringHead, 0);
+	SDL_AtomicSet(&ringTail, 0);
+	SDL_AtomicSet(&lostRecords, 0);
+	SDL_AtomicSet(&writerStopping, 0);
+
+	writerWake = SDL_CreateSemaphore(0);
+	writer = writerWake ? SDL_CreateThread(telemetryThread, "Telemetry", NULL) : NULL;
+	if (!writer)
+	{
+		printf("Couldn't start the telemetry writer: %s\n", SDL_GetError());
+		quitTelemetry();
+		return false;
+	}
+
+	telemetryEnabled = true;
+	return true;
+}
+
+// Function that stops the writer thread once it has written everything, and closes the file
+void quitTelemetry(void)
+{
+	telemetryEnabled = false;
+
+	if (writer)
+	{
+		SDL_AtomicSet(&writerStopping, 1);
+		SDL_SemPost(writerWake);
+		SDL_WaitThread(writer, NULL);
+		writer = NULL;
+	}
+
+	SDL_DestroySemaphore(writerWake);
+	writerWake = NULL;
+
+	if (file)
+		fclose(file);
+	file = NULL;
+
+	free(interval.frameTimes);
+	free(interval.tickTimes);
+	memset(&interval, 0, sizeof interval);
+}
+
+// Function that adds the time of a tick to the ring
+void recordTelemetryTick(Uint64 start)
+{
+	if (!telemetryEnabled)
+		return;
+
+	Uint64 counts = SDL_GetPerformanceCounter() - start;
+
+	TelemetryRecord record = {
+		.type = RECORD_TICK,
+		.duration = (Uint32)(counts * 1000000 / SDL_GetPerformanceFrequency()),
+	};
+
+	pushRecord(&record);
+}
+
+// Function that adds a frame to the ring, with the counters the world gathered during it
+void recordTelemetryFrame(World* world, double frameTime, int dropped)
+{
+	Uint32 shots = world->shotsFired;
+	Uint32 kills = world->enemiesKilled;
+
+	world->shotsFired = 0;
+	world->enemiesKilled = 0;
+
+	if (!telemetryEnabled)
+		return;
+
+	TelemetryRecord record = {
+		.type = RECORD_FRAME,
+		.gameOver = world->gameFinished,
+		.dropped = (Uint16)min(dropped, 0xFFFF),
+		.duration = (Uint32)(frameTime * 1000000.0),
+		.shots = shots,
+		.kills = kills,
+		.wave = world->currentWave,
+		.score = world->gameFinished ? world->lastGame.score : 0,
+	};
+
+	pushRecord(&record);
+}
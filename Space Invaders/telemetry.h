@@ -0,0 +1,48 @@
+#pragma once
+
+// SDL libraries
+#include <SDL.h>
+
+// Game modules
+#include "game.h"
+
+// Helper libraries
+#include <stdbool.h>
+
+#pragma region Structs and defines
+
+// Records the ring between the main thread and the writer holds, a power of two. Records that don't fit are counted and dropped
+#define TELEMETRY_RING_SIZE 8192
+
+// Default seconds between summary lines
+#define DEFAULT_TELEMETRY_INTERVAL 10
+
+// How often the writer empties the ring, in milliseconds
+#define TELEMETRY_POLL_TIME 100
+
+// File given with "--telemetry FILE" and the seconds between summaries with "--telemetry-interval N"
+typedef struct TelemetryOptions
+{
+	const char* path; // Lines of JSON are added to the end of it, NULL if not given
+	int interval;
+} TelemetryOptions;
+
+#pragma endregion
+
+#pragma region Function declarations
+
+// Parse telemetry options from the command line
+void parseTelemetryOptions(int argc, char* argv[], TelemetryOptions* options);
+
+// Initialization and exit. Exit writes what is left in the ring and the totals of the session
+bool initTelemetry(const TelemetryOptions* options);
+void quitTelemetry(void);
+
+// Time of a tick, from the counter value it started at to now
+void recordTelemetryTick(Uint64 start);
+
+// End of a frame, with its length in seconds and the frames of it the render thread never took.
+// The counters the world gathered are taken even when telemetry is off
+void recordTelemetryFrame(World* world, double frameTime, int dropped);
+
+#pragma endregion
@@ -0,0 +1,253 @@
+#include "text.h"
+
+// Standard libraries
+#include <stdlib.h>
+#include <stdio.h>
+
+// Width of the glyph atlas texture, glyphs wrap to a new row once a row is full
+#define ATLAS_WIDTH 512
+
+// Function that rasterizes every printable glyph of a font once into a single texture
+bool createGlyphAtlas(GlyphAtlas* atlas, SDL_Renderer* renderer, TTF_Font* font)
+{
+	SDL_Color white = { 255, 255, 255, 255 };
+	SDL_Surface* glyphSurfaces[GLYPH_COUNT] = { NULL };
+
+	SDL_zerop(atlas);
+
+	// Render every glyph and lay them out in rows
+	int x = 0, y = 0, rowHeight = 0;
+	for (int i = 0; i < GLYPH_COUNT; i++)
+	{
+		Uint16 ch = (Uint16)(FIRST_GLYPH + i);
+
+		int advance = 0;
+		TTF_GlyphMetrics(font, ch, NULL, NULL, NULL, NULL, &advance);
+		atlas->advance[i] = advance;
+
+		glyphSurfaces[i] = TTF_RenderGlyph_Blended(font, ch, white);
+		if (!glyphSurfaces[i])
+			continue;
+
+		// Wrap to the next row
+		if (x + glyphSurfaces[i]->w > ATLAS_WIDTH)
+		{
+			x = 0;
+			y += rowHeight;
+			rowHeight = 0;
+		}
+
+		atlas->glyphs[i] = (SDL_Rect){ .x = x, .y = y, .w = glyphSurfaces[i]->w, .h = glyphSurfaces[i]->h };
+
+		x += glyphSurfaces[i]->w;
+		rowHeight = max(rowHeight, glyphSurfaces[i]->h);
+	}
+
+	atlas->textureWidth = ATLAS_WIDTH;
+	atlas->textureHeight = y + rowHeight;
+
+	// Copy the glyphs into one surface and upload it to the GPU
+	bool success = false;
+	SDL_Surface* atlasSurface = SDL_CreateRGBSurfaceWithFormat(0, atlas->textureWidth, atlas->textureHeight, 32, SDL_PIXELFORMAT_RGBA32);
+
+	if (atlasSurface)
+	{
+		for (int i = 0; i < GLYPH_COUNT; i++)
+		{
+			if (glyphSurfaces[i])
+			{
+				// Copy alpha as is instead of blending it onto the empty atlas
+				SDL_SetSurfaceBlendMode(glyphSurfaces[i], SDL_BLENDMODE_NONE);
+				SDL_BlitSurface(glyphSurfaces[i], NULL, atlasSurface, &atlas->glyphs[i]);
+			}
+		}
+
+		atlas->texture = SDL_CreateTextureFromSurface(renderer, atlasSurface);
+		if (atlas->texture)
+		{
+			SDL_SetTextureBlendMode(atlas->texture, SDL_BLENDMODE_BLEND);
+			success = true;
+		}
+
+		SDL_FreeSurface(atlasSurface);
+	}
+
+	if (!success)
+		printf("Couldn't create glyph atlas: %s\n", SDL_GetError());
+
+	for (int i = 0; i < GLYPH_COUNT; i++)
+		SDL_FreeSurface(glyphSurfaces[i]);
+
+	return success;
+}
+
+// Free the texture used by a glyph atlas
+void freeGlyphAtlas(GlyphAtlas* atlas)
+{
+	SDL_DestroyTexture(atlas->texture);
+	atlas->texture = NULL;
+}
+
+// Function that draws a string from the glyph atlas with a single batched geometry call
+void drawAtlasText(SDL_Renderer* renderer, const GlyphAtlas* atlas, const char* text, SDL_Color color, int px, int py)
+{
+	SDL_Vertex vertices[MAX_TEXT_LENGTH * 4];
+	int indices[MAX_TEXT_LENGTH * 6];
+	int quads = 0;
+
+	float u = 1.0f / (float)atlas->textureWidth;
+	float v = 1.0f / (float)atlas->textureHeight;
+
+	int x = px;
+	for (const char* c = text; *c != '\0' && quads < MAX_TEXT_LENGTH; c++)
+	{
+		// Skip characters that are not in the atlas
+		if (*c < FIRST_GLYPH || *c > LAST_GLYPH)
+			continue;
+
+		int glyph = *c - FIRST_GLYPH;
+		const SDL_Rect* src = &atlas->glyphs[glyph];
+
+		if (src->w > 0 && src->h > 0)
+		{
+			float x0 = (float)x, y0 = (float)py;
+			float x1 = x0 + (float)src->w, y1 = y0 + (float)src->h;
+
+			float u0 = (float)src->x * u, v0 = (float)src->y * v;
+			float u1 = (float)(src->x + src->w) * u, v1 = (float)(src->y + src->h) * v;
+
+			SDL_Vertex* quad = &vertices[quads * 4];
+			quad[0] = (SDL_Vertex){ { x0, y0 }, color, { u0, v0 } };
+			quad[1] = (SDL_Vertex){ { x1, y0 }, color, { u1, v0 } };
+			quad[2] = (SDL_Vertex){ { x1, y1 }, color, { u1, v1 } };
+			quad[3] = (SDL_Vertex){ { x0, y1 }, color, { u0, v1 } };
+
+			// Two triangles per glyph
+			int* index = &indices[quads * 6];
+			int base = quads * 4;
+			index[0] = base; index[1] = base + 1; index[2] = base + 2;
+			index[3] = base; index[4] = base + 2; index[5] = base + 3;
+
+			quads++;
+		}
+
+		x += atlas->advance[glyph];
+	}
+
+	if (quads > 0)
+		SDL_RenderGeometry(renderer, atlas->texture, vertices, quads * 4, indices, quads * 6);
+}
+
+// Function that renders a string that never changes into its own texture
+bool createCachedText(CachedText* cached, SDL_Renderer* renderer, TTF_Font* font, const char* text, SDL_Color color)
+{
+	SDL_zerop(cached);
+
+	SDL_Surface* textSurface = TTF_RenderText_Blended(font, text, color);
+	if (!textSurface)
+	{
+		printf("Couldn't render text \"%s\": %s\n", text, TTF_GetError());
+		return false;
+	}
+
+	cached->texture = SDL_CreateTextureFromSurface(renderer, textSurface);
+	cached->w = textSurface->w;
+	cached->h = textSurface->h;
+
+	SDL_FreeSurface(textSurface);
+
+	return cached->texture != NULL;
+}
+
+// Free the texture used by a cached string
+void freeCachedText(CachedText* cached)
+{
+	SDL_DestroyTexture(cached->texture);
+	cached->texture = NULL;
+}
+
+// Draw a cached string at the given coordinates
+void drawCachedText(SDL_Renderer* renderer, const CachedText* cached, int px, int py)
+{
+	SDL_Rect textRect = { .x = px, .y = py, .w = cached->w, .h = cached->h };
+	SDL_RenderCopy(renderer, cached->texture, NULL, &textRect);
+}
+
+// Function that rebuilds the text of a HUD number only when its value has changed
+bool updateHudNumber(HudNumber* number, int value)
+{
+	if (number->valid && number->value == value)
+		return false;
+
+	snprintf(number->text, sizeof number->text, "%s%d", number->label, value);
+
+	number->value = value;
+	number->valid = true;
+
+	return true;
+}
+
+// Function that creates the render target of a text layer, which starts out dirty
+bool createTextLayer(TextLayer* layer, SDL_Renderer* renderer, int w, int h)
+{
+	SDL_zerop(layer);
+
+	layer->texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, w, h);
+	if (!layer->texture)
+	{
+		printf("Couldn't create text layer: %s\n", SDL_GetError());
+		return false;
+	}
+
+	// Text blended onto a transparent target ends up with premultiplied alpha, so it has to be drawn as such.
+	// Renderers without custom blend modes fall back to normal blending, which only darkens the edges slightly
+	SDL_BlendMode premultiplied = SDL_ComposeCustomBlendMode(
+		SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+		SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+
+	if (SDL_SetTextureBlendMode(layer->texture, premultiplied) != 0)
+		SDL_SetTextureBlendMode(layer->texture, SDL_BLENDMODE_BLEND);
+
+	layer->w = w;
+	layer->h = h;
+	layer->dirty = true;
+
+	return true;
+}
+
+// Free the texture used by a text layer
+void freeTextLayer(TextLayer* layer)
+{
+	SDL_DestroyTexture(layer->texture);
+	layer->texture = NULL;
+}
+
+// Function that redirects rendering into a layer and clears it to transparent
+bool beginTextLayer(TextLayer* layer, SDL_Renderer* renderer)
+{
+	SDL_Texture* previous = SDL_GetRenderTarget(renderer);
+
+	if (!layer->texture || SDL_SetRenderTarget(renderer, layer->texture) != 0)
+		return false;
+
+	layer->previous = previous;
+
+	SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+	SDL_RenderClear(renderer);
+
+	return true;
+}
+
+// Function that sends rendering back to where it went before, the layer stays as it is until it's marked dirty again
+void endTextLayer(TextLayer* layer, SDL_Renderer* renderer)
+{
+	SDL_SetRenderTarget(renderer, layer->previous);
+	layer->dirty = false;
+}
+
+// Draw a text layer at the given coordinates
+void drawTextLayer(SDL_Renderer* renderer, const TextLayer* layer, int px, int py)
+{
+	SDL_Rect layerRect = { .x = px, .y = py, .w = layer->w, .h = layer->h };
+	SDL_RenderCopy(renderer, layer->texture, NULL, &layerRect);
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+// SDL libraries
+#include <SDL.h>
+#include <SDL_ttf.h>
+
+// Helper libraries
+#include <stdbool.h>
+
+#pragma region Structs and defines
+
+// Printable ASCII range that gets rasterized into the glyph atlas
+#define FIRST_GLYPH 32
+#define LAST_GLYPH 126
+#define GLYPH_COUNT (LAST_GLYPH - FIRST_GLYPH + 1)
+
+// Longest string that can be drawn in a single batch
+#define MAX_TEXT_LENGTH 64
+
+typedef struct GlyphAtlas
+{
+	SDL_Texture* texture; // Texture containing every glyph of the font, rendered in white
+
+	SDL_Rect glyphs[GLYPH_COUNT]; // Location of each glyph inside the texture
+	int advance[GLYPH_COUNT]; // Horizontal advance of each glyph
+
+	int textureWidth, textureHeight; // Size of the atlas texture, used for texture coordinates
+} GlyphAtlas;
+
+typedef struct CachedText
+{
+	SDL_Texture* texture; // Pre-rendered texture of a string that never changes
+	int w, h; // Size of the texture
+} CachedText;
+
+typedef struct HudNumber
+{
+	const char* label; // Text shown in front of the number
+	int value; // The value that the current text was built from
+	bool valid; // False until the text has been built for the first time
+
+	char text[MAX_TEXT_LENGTH]; // Label and value concatenated
+} HudNumber;
+
+// Texture that a group of text is composed into once, and drawn with a single copy until it changes
+typedef struct TextLayer
+{
+	SDL_Texture* texture; // Render target holding the composed text
+	int w, h; // Size of the texture
+	bool dirty; // True when the texture has to be composed again
+	SDL_Texture* previous; // Target that was drawn to before the layer was begun, drawn to again once it ends
+} TextLayer;
+
+#pragma endregion
+
+#pragma region Function declarations
+
+// Glyph atlas
+bool createGlyphAtlas(GlyphAtlas* atlas, SDL_Renderer* renderer, TTF_Font* font);
+void freeGlyphAtlas(GlyphAtlas* atlas);
+void drawAtlasText(SDL_Renderer* renderer, const GlyphAtlas* atlas, const char* text, SDL_Color color, int px, int py);
+
+// Static strings
+bool createCachedText(CachedText* cached, SDL_Renderer* renderer, TTF_Font* font, const char* text, SDL_Color color);
+void freeCachedText(CachedText* cached);
+void drawCachedText(SDL_Renderer* renderer, const CachedText* cached, int px, int py);
+
+// HUD numbers, returns true if the text changed
+bool updateHudNumber(HudNumber* number, int value);
+
+// Layers, everything drawn between begin and end goes into the layer instead of the current target
+bool createTextLayer(TextLayer* layer, SDL_Renderer* renderer, int w, int h);
+void freeTextLayer(TextLayer* layer);
+bool beginTextLayer(TextLayer* layer, SDL_Renderer* renderer);
+void endTextLayer(TextLayer* layer, SDL_Renderer* renderer);
+void drawTextLayer(SDL_Renderer* renderer, const TextLayer* layer, int px, int py);
+
+#pragma endregion
@@ -0,0 +1,258 @@
+#include "tunables.h"
+
+// Only dev builds read the tunables from a file, every other build has them as constants in the header
+#ifdef HOT_TUNABLES
+
+// Game modules
+#include "bytes.h"
+
+// Standard libraries
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+// Longest name or value read from a line of the file
+#define MAX_TUNABLE_TEXT 64
+
+#pragma region Structs and ENUMs
+
+typedef enum TunableType { TUNABLE_TYPE_int, TUNABLE_TYPE_float } TunableType;
+
+// Where a tunable lives in the struct, found by its name in the file
+typedef struct TunableField
+{
+	const char* name;
+	size_t offset;
+	TunableType type;
+	TunableKind kind;
+} TunableField;
+
+#pragma endregion
+
+#pragma region Globals
+
+#define TUNABLE_FIELD(type, name, value, kind) { #name, offsetof(Tunables, name), TUNABLE_TYPE_##type, kind },
+
+Tunables tunables = { TUNABLES(TUNABLE_DEFAULT) };
+
+static const TunableField fields[] = { TUNABLES(TUNABLE_FIELD) };
+
+#define FIELD_COUNT (int)(sizeof fields / sizeof fields[0])
+
+static const char* tunablesPath = NULL;
+
+// The file is compared by its contents, which works the same for editors that write it in place and ones that replace it
+static Uint32 loadedHash = 0;
+static size_t loadedSize = 0;
+static Uint32 lastPoll = 0;
+
+#pragma endregion
+
+#pragma region Helpers
+
+// Helper function for getting the field a name in the file refers to, NULL if there is none
+static const TunableField* findField(const char* name)
+{
+	for (int n = 0; n < FIELD_COUNT; n++)
+	{
+		if (strcmp(fields[n].name, name) == 0)
+			return &fields[n];
+	}
+
+	return NULL;
+}
+
+// Helper function for getting the size of a field
+static inline size_t getFieldSize(const TunableField* field)
+{
+	return field->type == TUNABLE_TYPE_int ? sizeof(int) : sizeof(float);
+}
+
+// Function that writes every tunable with its default value, so there is a file to start editing from
+static bool writeDefaultTunables(const char* path)
+{
+	FILE* file = fopen(path, "w");
+	if (!file)
+	{
+		printf("Couldn't write the default tunables to %s\n", path);
+		return false;
+	}
+
+	static const Tunables defaults = { TUNABLES(TUNABLE_DEFAULT) };
+
+	fprintf(file, "# Tunables of Space Invaders, read again whenever this file is saved. Lines are \"name = value\"\n");
+
+	for (int n = 0; n < FIELD_COUNT; n++)
+	{
+		const char* value = (const char*)&defaults + fields[n].offset;
+
+		if (fields[n].type == TUNABLE_TYPE_int)
+			fprintf(file, "%s = %d", fields[n].name, *(const int*)value);
+		else
+			fprintf(file, "%s = %g", fields[n].name, *(const float*)value);
+
+		fprintf(file, fields[n].kind == TUNABLE_RESTART ? " # needs a restart\n" : "\n");
+	}
+
+	return fclose(file) == 0;
+}
+
+// Function that reads every "name = value" line of a file over the given tunables. Comments start with '#'.
+// Returns false if any line is wrong, the tunables are only partly read then
+static bool parseTunables(char* text, Tunables* values)
+{
+	bool success = true;
+	int lineNumber = 0;
+
+	for (char* line = text; line; )
+	{
+		char* next = strchr(line, '\n');
+		if (next)
+			*next++ = '\0';
+
+		lineNumber++;
+
+		char* comment = strchr(line, '#');
+		if (comment)
+			*comment = '\0';
+
+		char name[MAX_TUNABLE_TEXT], value[MAX_TUNABLE_TEXT], rest;
+		int read = sscanf(line, " %63[A-Za-z0-9_] = %63s %c", name, value, &rest);
+
+		// Empty lines and lines with only a comment
+		if (read == EOF)
+		{
+			line = next;
+			continue;
+		}
+
+		const TunableField* field = read == 2 ? findField(name) : NULL;
+		char* end = value;
+
+		if (field)
+		{
+			char* target = (char*)values + field->offset;
+
+			if (field->type == TUNABLE_TYPE_int)
+				*(int*)target = (int)strtol(value, &end, 10);
+			else
+				*(float*)target = strtof(value, &end);
+		}
+
+		if (!field || *end != '\0')
+		{
+			printf("%s:%d: expected \"name = value\" with a known name and a number\n", tunablesPath, lineNumber);
+			success = false;
+		}
+
+		line = next;
+	}
+
+	return success;
+}
+
+// Function that reads the file if its contents changed since the last time. Returns true if the tunables were replaced
+static bool loadTunables(bool restartFields)
+{
+	size_t size;
+	char* text = (char*)SDL_LoadFile(tunablesPath, &size);
+
+	// A file being saved can briefly be missing, the values it had are kept
+	if (!text)
+		return false;
+
+	Uint32 hash = hashBytes(FNV_OFFSET_BASIS, text, size);
+	if (hash == loadedHash && size == loadedSize)
+	{
+		SDL_free(text);
+		return false;
+	}
+
+	loadedHash = hash;
+	loadedSize = size;
+
+	// Nothing is taken from a file with a mistake in it, so the game never runs with half an edit
+	Tunables values = tunables;
+	bool success = parseTunables(text, &values);
+	SDL_free(text);
+
+	if (!success)
+	{
+		printf("Kept the tunables from before, fix %s to load it\n", tunablesPath);
+		return false;
+	}
+
+	for (int n = 0; n < FIELD_COUNT && !restartFields; n++)
+	{
+		const TunableField* field = &fields[n];
+
+		char* value = (char*)&values + field->offset;
+		const char* current = (const char*)&tunables + field->offset;
+
+		if (field->kind == TUNABLE_RESTART && memcmp(value, current, getFieldSize(field)) != 0)
+		{
+			printf("%s only changes with a restart\n", field->name);
+			memcpy(value, current, getFieldSize(field));
+		}
+	}
+
+	bool changed = memcmp(&values, &tunables, sizeof values) != 0;
+	tunables = values;
+
+	return changed;
+}
+
+#pragma endregion
+
+// Function that picks up "--tunables FILE" from the command line
+void parseTunablesOptions(int argc, char* argv[], TunablesOptions* options)
+{
+	options->path = DEFAULT_TUNABLES_PATH;
+
+	for (int i = 1; i < argc - 1; i++)
+	{
+		if (strcmp(argv[i], "--tunables") == 0)
+			options->path = argv[++i];
+	}
+}
+
+// Function that reads the tunables file, or writes one with the defaults if there is none yet
+bool initTunables(const TunablesOptions* options)
+{
+	tunablesPath = options->path;
+	loadedHash = 0;
+	loadedSize = 0;
+	lastPoll = SDL_GetTicks();
+
+	FILE* file = fopen(tunablesPath, "r");
+
+	if (file)
+		fclose(file);
+	else if (!writeDefaultTunables(tunablesPath))
+		return false;
+
+	// Nothing has been built from the tunables yet, so every field can change
+	loadTunables(true);
+	printf("Tunables are read from %s, saving it applies the changes\n", tunablesPath);
+
+	return true;
+}
+
+// Function that reloads the file once in a while, between frames so every tick sees the same values from start to end
+bool pollTunables(Tunables* previous)
+{
+	Uint32 now = SDL_GetTicks();
+	if (!tunablesPath || now - lastPoll < TUNABLES_POLL_TIME)
+		return false;
+
+	lastPoll = now;
+	*previous = tunables;
+
+	if (!loadTunables(false))
+		return false;
+
+	printf("Reloaded the tunables from %s\n", tunablesPath);
+	return true;
+}
+
+#endif
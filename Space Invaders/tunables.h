@@ -0,0 +1,101 @@
+#pragma once
+
+// SDL libraries
+#include <SDL.h>
+
+// Game modules
+#include "bytes.h"
+
+// Helper libraries
+#include <stdbool.h>
+#include <stddef.h>
+
+#pragma region Schema
+
+// When a change to a tunable takes effect. Enemy sizes lay out the world block and the particle lifetime is taken when the world is created,
+// so those wait for a restart
+typedef enum TunableKind { TUNABLE_LIVE, TUNABLE_RESTART } TunableKind;
+
+// Every tunable of the game: type, name, default value and when a change takes effect. The name is also its key in the tunables file.
+// Speeds are in pixels per second, sizes in pixels and times in seconds. The kill reward is multiplied by the wave number, enemies wait
+// the shoot cooldown on top of a random wait after they shoot, and every column of the formation fires at the fire rate on average once
+// its cooldown is over. The enemy speed offset starts at its base and grows by its increase for every kill, the enemy speed multiplier
+// grows every time the formation changes direction
+#define TUNABLES(X) \
+	X(int, playerSpeed, 200, TUNABLE_LIVE) \
+	X(int, enemySpeed, 20, TUNABLE_LIVE) \
+	X(int, bulletSpeed, 275, TUNABLE_LIVE) \
+	X(float, baseEnemySpeedOffset, 0.0f, TUNABLE_LIVE) \
+	X(float, enemySpeedOffsetIncr, 1.25f, TUNABLE_LIVE) \
+	X(float, enemySpeedMult, 1.0f, TUNABLE_LIVE) \
+	X(int, killReward, 10, TUNABLE_LIVE) \
+	X(float, shootCooldown, 0.75f, TUNABLE_LIVE) \
+	X(float, playerShootOffset, 1.30f, TUNABLE_LIVE) \
+	X(float, enemyFireRate, 0.12f, TUNABLE_LIVE) \
+	X(float, playerWidth, 20.0f, TUNABLE_LIVE) \
+	X(float, playerHeight, 20.0f, TUNABLE_LIVE) \
+	X(float, enemyWidth, 30.0f, TUNABLE_RESTART) \
+	X(float, enemyHeight, 30.0f, TUNABLE_RESTART) \
+	X(float, bulletWidth, 10.0f, TUNABLE_LIVE) \
+	X(float, bulletHeight, 15.0f, TUNABLE_LIVE) \
+	X(float, particleWidth, 20.0f, TUNABLE_LIVE) \
+	X(float, particleHeight, 20.0f, TUNABLE_LIVE) \
+	X(float, particleLifetime, 0.5f, TUNABLE_RESTART)
+
+#define TUNABLE_MEMBER(type, name, value, kind) type name;
+#define TUNABLE_DEFAULT(type, name, value, kind) .name = value,
+
+typedef struct Tunables
+{
+	TUNABLES(TUNABLE_MEMBER)
+} Tunables;
+
+// Dev builds read the tunables from a file and reload it while the game runs. Every other build bakes the defaults in as constants,
+// so the compiler folds them into the code that uses them just like literals
+#ifdef HOT_TUNABLES
+extern Tunables tunables;
+#else
+static const Tunables tunables = { TUNABLES(TUNABLE_DEFAULT) };
+#endif
+
+// Hash of the tunables the game runs with. Recordings and netplay sessions carry it, they only play out the same with the same values.
+// Every tunable is an int or a float, so the struct has no padding and the hash only depends on the values
+static inline Uint32 hashTunables(void)
+{
+	return hashBytes(FNV_OFFSET_BASIS, &tunables, sizeof tunables);
+}
+
+#pragma endregion
+
+#ifdef HOT_TUNABLES
+
+#pragma region Structs and defines
+
+// File used when "--tunables FILE" isn't given, next to where the game is started from
+#define DEFAULT_TUNABLES_PATH "tunables.cfg"
+
+// How often the file is checked for changes, in milliseconds
+#define TUNABLES_POLL_TIME 250
+
+// File given with "--tunables FILE"
+typedef struct TunablesOptions
+{
+	const char* path;
+} TunablesOptions;
+
+#pragma endregion
+
+#pragma region Function declarations
+
+// Parse tunables options from the command line
+void parseTunablesOptions(int argc, char* argv[], TunablesOptions* options);
+
+// Read the tunables file, writing it with the defaults first if it doesn't exist. Has to run before anything reads the tunables
+bool initTunables(const TunablesOptions* options);
+
+// Reload the file if it changed since it was last read. Returns true if any value changed, with the values from before in previous
+bool pollTunables(Tunables* previous);
+
+#pragma endregion
+
+#endif
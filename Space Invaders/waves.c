@@ -0,0 +1,170 @@
+#include "waves.h"
+
+// Game modules
+#include "bytes.h"
+
+// Standard libraries
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+// Longest layout name read from a line
+#define MAX_LAYOUT_NAME 16
+
+// Names of the layouts in schedule files
+static const char* layoutNames[LAYOUT_COUNT] = {
+	[LAYOUT_FULL] = "full",
+	[LAYOUT_CHECKER] = "checker",
+	[LAYOUT_WEDGE] = "wedge",
+	[LAYOUT_COLUMNS] = "columns",
+};
+
+// Helper function that sets the reward of the waves past the end from the last two waves
+static void finishSchedule(WaveSchedule* schedule)
+{
+	int count = schedule->count;
+	schedule->rewardStep = count >= 2 ? schedule->waves[count - 1].reward - schedule->waves[count - 2].reward : 0;
+}
+
+// Function that fills a schedule with the formula the game has always used, bottom rows shoot sooner every wave down to a fifth of a second
+void buildDefaultWaves(WaveSchedule* schedule, int killReward, float fireRate, float speedOffset)
+{
+	schedule->count = MAX_WAVES;
+
+	for (int n = 0; n < MAX_WAVES; n++)
+	{
+		int wave = n + 1;
+
+		schedule->waves[n] = (WaveParams){
+			.reward = killReward * wave,
+			.firstShot = max(0.20f, 1 - (0.05f * wave)),
+			.fireRate = fireRate,
+			.speedOffset = speedOffset,
+			.layout = LAYOUT_FULL,
+		};
+	}
+
+	finishSchedule(schedule);
+}
+
+// Function that reads an authored schedule from a file, leaving the schedule as it was if anything in it is wrong
+bool loadWaveSchedule(WaveSchedule* schedule, const char* path)
+{
+	size_t size;
+	char* text = (char*)SDL_LoadFile(path, &size);
+
+	if (!text)
+	{
+		printf("Couldn't read the waves from %s: %s\n", path, SDL_GetError());
+		return false;
+	}
+
+	WaveSchedule loaded = { .count = 0 };
+	bool success = true;
+	int lineNumber = 0;
+
+	for (char* line = text; line && success; )
+	{
+		char* next = strchr(line, '\n');
+		if (next)
+			*next++ = '\0';
+
+		lineNumber++;
+
+		char* comment = strchr(line, '#');
+		if (comment)
+			*comment = '\0';
+
+		WaveParams wave;
+		char layout[MAX_LAYOUT_NAME];
+		int read = sscanf(line, "%d %f %f %f %15s", &wave.reward, &wave.firstShot, &wave.fireRate, &wave.speedOffset, layout);
+
+		line = next;
+
+		// Empty lines and lines with only a comment
+		if (read == EOF)
+			continue;
+
+		wave.layout = LAYOUT_COUNT;
+		for (int n = 0; n < LAYOUT_COUNT && read == 5; n++)
+		{
+			if (strcmp(layout, layoutNames[n]) == 0)
+				wave.layout = (WaveLayout)n;
+		}
+
+		if (read != 5 || wave.layout == LAYOUT_COUNT || wave.reward < 0 || wave.firstShot < 0.0f || wave.fireRate <= 0.0f)
+		{
+			printf("%s:%d: expected \"reward first_shot fire_rate speed_offset layout\", layouts are full, checker, wedge and columns\n", path, lineNumber);
+			success = false;
+		}
+		else if (loaded.count == MAX_WAVES)
+		{
+			printf("%s:%d: a schedule holds at most %d waves\n", path, lineNumber, MAX_WAVES);
+			success = false;
+		}
+		else
+		{
+			loaded.waves[loaded.count++] = wave;
+		}
+	}
+
+	SDL_free(text);
+
+	if (success && loaded.count == 0)
+	{
+		printf("%s has no waves\n", path);
+		success = false;
+	}
+
+	if (success)
+	{
+		finishSchedule(&loaded);
+		*schedule = loaded;
+	}
+
+	return success;
+}
+
+// Function for getting the parameters of a wave, the last wave of the schedule stands in for every wave after it
+WaveParams getWaveParams(const WaveSchedule* schedule, int wave)
+{
+	if (wave <= schedule->count)
+		return schedule->waves[max(wave, 1) - 1];
+
+	WaveParams params = schedule->waves[schedule->count - 1];
+	params.reward += schedule->rewardStep * (wave - schedule->count);
+
+	return params;
+}
+
+// Function that hashes the waves of a schedule with FNV-1a, the entries past the count don't take part
+Uint32 hashWaveSchedule(const WaveSchedule* schedule)
+{
+	Uint32 hash = hashBytes(FNV_OFFSET_BASIS, schedule->waves, (size_t)schedule->count * sizeof(WaveParams));
+
+	// The step past the end follows from the waves, so the count is all that's left
+	hash ^= (Uint32)schedule->count;
+	hash *= FNV_PRIME;
+
+	return hash;
+}
+
+// Function that tells whether a layout fills a cell, rows are counted from the top
+bool isLayoutCell(WaveLayout layout, int col, int row, int cols, int rows)
+{
+	switch (layout)
+	{
+	case LAYOUT_CHECKER:
+		return (col + row) % 2 == 0;
+
+	case LAYOUT_WEDGE:
+		// Each row down is wider, the bottom row spans the whole formation
+		return abs(2 * col - (cols - 1)) <= (cols - 1) * (row + 1) / rows;
+
+	case LAYOUT_COLUMNS:
+		return col % 2 == 0;
+
+	default:
+		return true;
+	}
+}
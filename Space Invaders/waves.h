@@ -0,0 +1,61 @@
+#pragma once
+
+// SDL libraries
+#include <SDL.h>
+
+// Helper libraries
+#include <stdbool.h>
+
+#pragma region Structs and defines
+
+// Most waves a schedule holds, waves past the last one repeat it
+#define MAX_WAVES 64
+
+// Which cells of the formation a wave fills, every layout fills at least one cell of any formation
+typedef enum WaveLayout
+{
+	LAYOUT_FULL, // Every cell
+	LAYOUT_CHECKER, // Every other cell, alternating between rows
+	LAYOUT_WEDGE, // A triangle pointing up, with a full bottom row
+	LAYOUT_COLUMNS, // Every other column
+	LAYOUT_COUNT
+} WaveLayout;
+
+// Everything a wave starts with, computed before the game starts so a new wave only copies it out
+typedef struct WaveParams
+{
+	int reward; // Score for every enemy of the wave
+	float firstShot; // Wait of the bottom row before its first random wait
+	float fireRate; // Average shots per second of every column once its cooldown is over
+	float speedOffset; // Enemy speed offset the wave starts at, every kill adds to it
+	WaveLayout layout;
+} WaveParams;
+
+// Waves of a game in order. Waves past the last repeat it, with the reward still growing by the step between the last two
+typedef struct WaveSchedule
+{
+	WaveParams waves[MAX_WAVES];
+	int count;
+	int rewardStep;
+} WaveSchedule;
+
+#pragma endregion
+
+#pragma region Function declarations
+
+// The progression of the original game: the reward grows with the wave number and enemies start shooting sooner, the formation is always full
+void buildDefaultWaves(WaveSchedule* schedule, int killReward, float fireRate, float speedOffset);
+
+// Read an authored schedule, a wave per line: "reward first_shot fire_rate speed_offset layout". Lines starting with '#' are comments
+bool loadWaveSchedule(WaveSchedule* schedule, const char* path);
+
+// Parameters of a wave, counted from 1
+WaveParams getWaveParams(const WaveSchedule* schedule, int wave);
+
+// Hash of the waves of a schedule, so recordings can tell whether they are played with the waves they were recorded with
+Uint32 hashWaveSchedule(const WaveSchedule* schedule);
+
+// Whether a wave with the given layout fills the cell at a column and row of a formation
+bool isLayoutCell(WaveLayout layout, int col, int row, int cols, int rows);
+
+#pragma endregion
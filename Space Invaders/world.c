@@ -0,0 +1,167 @@
+#include "game.h"
+
+// Standard libraries
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+// Every part of the block starts on this alignment, so the arrays of every part stay aligned for their type
+#define WORLD_ALIGNMENT 16
+
+// Parts of the block: the enemy and bullet stores, the particles, the formation, the grid and the bullet mask
+#define WORLD_PARTS 6
+
+#pragma region Helpers
+
+// Round a size up to the alignment of the block
+static inline size_t alignSize(size_t size)
+{
+	return (size + WORLD_ALIGNMENT - 1) & ~(size_t)(WORLD_ALIGNMENT - 1);
+}
+
+// One cell per formation slot, so a bullet maps straight to the columns and rows around it
+static inline float getGridCellSize(void)
+{
+	return max(tunables.enemyWidth, tunables.enemyHeight) + FORMATION_GAP;
+}
+
+// Function for getting the size of every part of the block, in the order they are placed
+static void getWorldSizes(const GameConfig* config, size_t sizes[WORLD_PARTS])
+{
+	int cols = config->formationCols;
+	int rows = config->formationRows;
+	float cellSize = getGridCellSize();
+
+	sizes[0] = alignSize(getEntityStoreSize(cols * rows));
+	sizes[1] = alignSize(getEntityStoreSize(config->maxBullets));
+	sizes[2] = alignSize(getParticleEmitterSize(config->maxParticles));
+	sizes[3] = alignSize(getFormationSize(cols, rows));
+	sizes[4] = alignSize(getCollisionGridSize(cellSize * cols, cellSize * rows, cellSize, cols * rows));
+	sizes[5] = alignSize(sizeof(Uint32) * (size_t)((config->maxBullets + 31) / 32));
+}
+
+// Function that points every array of the world into its block. Only pointers are set, so it also repairs a copied world
+static void bindWorld(World* world)
+{
+	const GameConfig* config = &world->config;
+
+	int cols = config->formationCols;
+	int rows = config->formationRows;
+	float cellSize = getGridCellSize();
+
+	size_t sizes[WORLD_PARTS];
+	getWorldSizes(config, sizes);
+
+	char* block = (char*)world->memory;
+
+	bindEntityStore(&world->enemies, block, cols * rows);
+	block += sizes[0];
+
+	bindEntityStore(&world->bullets, block, config->maxBullets);
+	block += sizes[1];
+
+	bindParticleEmitter(&world->particles, block, config->maxParticles);
+	block += sizes[2];
+
+	bindFormation(&world->formation, block, cols, rows);
+	block += sizes[3];
+
+	bindCollisionGrid(&world->enemyGrid, block, cellSize * cols, cellSize * rows, cellSize, cols * rows);
+	block += sizes[4];
+
+	world->bulletsOutside = (Uint32*)block;
+}
+
+#pragma endregion
+
+// Function that allocates every array of a world in a single block and starts it out empty
+bool createWorld(World* world, const GameConfig* config)
+{
+	memset(world, 0, sizeof *world);
+	world->config = *config;
+
+	size_t sizes[WORLD_PARTS];
+	getWorldSizes(config, sizes);
+
+	world->memorySize = 0;
+	for (int part = 0; part < WORLD_PARTS; part++)
+		world->memorySize += sizes[part];
+	world->memory = malloc(world->memorySize);
+
+	if (!world->memory) {
+		printf("Couldn't allocate the world\n");
+		world->memorySize = 0;
+		return false;
+	}
+
+	// Padding between the parts is never written otherwise, clearing it keeps copies of the block identical
+	memset(world->memory, 0, world->memorySize);
+
+	bindWorld(world);
+
+	initEntityStore(&world->enemies);
+	initEntityStore(&world->bullets);
+	clearParticles(&world->particles);
+	resetFormation(&world->formation, 0, 0);
+
+	world->particles.lifetime = (Uint32)(tunables.particleLifetime * TICK_RATE + 0.5f);
+
+	return true;
+}
+
+// Free the block of a world, every array in it goes with it
+void destroyWorld(World* world)
+{
+	free(world->memory);
+	memset(world, 0, sizeof *world);
+}
+
+// Function that allocates a snapshot the size of a world and saves the world into it
+bool createSnapshot(WorldSnapshot* snapshot, const World* world)
+{
+	memset(snapshot, 0, sizeof *snapshot);
+
+	snapshot->memory = malloc(world->memorySize);
+	if (!snapshot->memory) {
+		printf("Couldn't allocate a snapshot\n");
+		return false;
+	}
+
+	saveSnapshot(snapshot, world);
+
+	return true;
+}
+
+// Free the block of a snapshot
+void freeSnapshot(WorldSnapshot* snapshot)
+{
+	free(snapshot->memory);
+	memset(snapshot, 0, sizeof *snapshot);
+}
+
+// Function that copies a world into a snapshot created for a world of the same config
+void saveSnapshot(WorldSnapshot* snapshot, const World* world)
+{
+	snapshot->world = *world;
+	memcpy(snapshot->memory, world->memory, world->memorySize);
+}
+
+// Function that copies a snapshot back into a world. The world keeps its own block, so its arrays are pointed back into it
+bool restoreSnapshot(World* world, const WorldSnapshot* snapshot)
+{
+	if (world->memorySize != snapshot->world.memorySize || memcmp(&world->config, &snapshot->world.config, sizeof world->config) != 0)
+	{
+		printf("Snapshot doesn't fit the world\n");
+		return false;
+	}
+
+	void* memory = world->memory;
+
+	*world = snapshot->world;
+	world->memory = memory;
+
+	bindWorld(world);
+	memcpy(world->memory, snapshot->memory, world->memorySize);
+
+	return true;
+}
@@ -0,0 +1,422 @@
+// Checks of the structures the game shares between threads, run after changing any of them. They print what went wrong and
+// exit with 1 if anything did. Races only show up reliably under a thread sanitizer, so besides running the project in Visual Studio
+// the checks are meant to be built with one where it's available, for example:
+//   clang -std=c17 -g -O1 -fsanitize=thread -DHEADLESS -I"Space Invaders" $(sdl2-config --cflags)
+//     ThreadChecks/threadchecks.c "Space Invaders/drawlist.c" "Space Invaders/particles.c" "Space Invaders/profiler.c"
+//     "Space Invaders/scores.c" $(sdl2-config --libs)
+
+// SDL libraries
+#include <SDL.h>
+
+// Game modules
+#include "drawlist.h"
+#include "profiler.h"
+#include "scores.h"
+
+// Standard libraries
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+// Helper libraries
+#include <stdbool.h>
+
+#pragma region Structs and defines
+
+// Lists published by every run of the draw queue check, and the most sprites one holds
+#define DRAW_CHECK_LISTS 100000
+#define DRAW_CHECK_SPRITES 64
+
+// Every how many lists one carries an input time
+#define DRAW_CHECK_INPUT_EVERY 7
+
+// Longest wait for the render side before the simulation side goes on, the same as the game's
+#define DRAW_CHECK_WAIT 100
+
+// Table the high score check writes, in the working directory, and the file the writer puts next to it first
+#define SCORES_CHECK_FILE "threadchecks_scores.dat"
+#define SCORES_CHECK_TEMP SCORES_CHECK_FILE ".tmp"
+
+// Games saved one right after the other, so the writer thread is handed new contents while it's still writing
+#define SCORES_CHECK_BURST 2000
+
+// Samples the profiler check adds on one thread while the other reads the stats
+#define PROFILER_CHECK_SAMPLES 200000
+
+// What the render side of the draw queue check saw
+typedef struct DrawCheck
+{
+	DrawQueue queue;
+
+	long drawn;
+	long lastFrame; // Frame of the last list taken, -1 before the first
+	long errors;
+} DrawCheck;
+
+#pragma endregion
+
+#pragma region Draw queue
+
+// Helper function for the frame that published a list with an input time is the first to show, 0 if none of the given frames has one
+static Uint64 firstInputTime(long first, long last)
+{
+	for (long frame = max(first, 0); frame <= last; frame++)
+	{
+		if (frame % DRAW_CHECK_INPUT_EVERY == 0)
+			return (Uint64)frame + 1;
+	}
+
+	return 0;
+}
+
+// Function that plays the render thread: takes lists until the queue stops and checks every one of them as it draws it
+static int drawCheckThread(void* data)
+{
+	DrawCheck* check = (DrawCheck*)data;
+
+	const DrawList* list;
+	while ((list = takeDrawList(&check->queue)) != NULL)
+	{
+		// The simulation writes its frame into the score and into every sprite, a torn list has them disagree
+		long frame = list->score;
+
+		for (int i = 0; i < list->count; i++)
+		{
+			if (list->sprites[i].px != (float)frame)
+			{
+				printf("Draw queue: list of frame %ld has a sprite of frame %.0f\n", frame, list->sprites[i].px);
+				check->errors++;
+				break;
+			}
+		}
+
+		// Lists are never drawn twice or out of order
+		if (frame <= check->lastFrame)
+		{
+			printf("Draw queue: took frame %ld after frame %ld\n", frame, check->lastFrame);
+			check->errors++;
+		}
+
+		// Dropped lists hand the oldest input time to the list drawn in their place, so it's always the first since the last drawn list
+		Uint64 expected = firstInputTime(check->lastFrame + 1, frame);
+		if (list->inputTime != expected)
+		{
+			printf("Draw queue: frame %ld has input time %llu, expected %llu\n", frame, (unsigned long long)list->inputTime, (unsigned long long)expected);
+			check->errors++;
+		}
+
+		check->lastFrame = frame;
+		check->drawn++;
+	}
+
+	return 0;
+}
+
+// Function that publishes lists to a render thread, waiting for it to take each one first when lockStep is true like the game does
+static bool checkDrawQueue(bool lockStep)
+{
+	static DrawCheck check;
+	memset(&check, 0, sizeof check);
+	check.lastFrame = -1;
+
+	if (!createDrawQueue(&check.queue, DRAW_CHECK_SPRITES))
+		return false;
+
+	SDL_Thread* thread = SDL_CreateThread(drawCheckThread, "drawCheck", &check);
+	if (!thread)
+	{
+		printf("Couldn't start the render side of the draw queue check: %s\n", SDL_GetError());
+		freeDrawQueue(&check.queue);
+		return false;
+	}
+
+	int timeouts = 0, dropped = 0;
+
+	for (long frame = 0; frame < DRAW_CHECK_LISTS; frame++)
+	{
+		if (lockStep && !waitForDrawListTaken(&check.queue, DRAW_CHECK_WAIT))
+			timeouts++;
+
+		DrawList* list = beginDrawList(&check.queue);
+
+		list->score = (int)frame;
+		list->count = 1 + (int)(frame % DRAW_CHECK_SPRITES);
+		for (int i = 0; i < list->count; i++)
+			list->sprites[i].px = (float)frame;
+
+		if (frame % DRAW_CHECK_INPUT_EVERY == 0)
+			list->inputTime = (Uint64)frame + 1;
+
+		publishDrawList(&check.queue);
+
+		dropped += check.queue.dropped;
+		check.queue.dropped = 0;
+	}
+
+	// The last list is drawn before the queue stops
+	if (!waitForDrawListTaken(&check.queue, DRAW_CHECK_WAIT))
+		timeouts++;
+
+	stopDrawQueue(&check.queue);
+	SDL_WaitThread(thread, NULL);
+
+	// Waiting on a stopped queue returns right away
+	if (!waitForDrawListTaken(&check.queue, DRAW_CHECK_WAIT))
+	{
+		printf("Draw queue: waiting on a stopped queue timed out\n");
+		check.errors++;
+	}
+
+	freeDrawQueue(&check.queue);
+
+	if (check.lastFrame != DRAW_CHECK_LISTS - 1)
+	{
+		printf("Draw queue: the last list drawn was frame %ld, expected %d\n", check.lastFrame, DRAW_CHECK_LISTS - 1);
+		check.errors++;
+	}
+
+	// In lock step the simulation is never more than a list ahead, so nothing is dropped unless the render side stalled
+	if (lockStep && dropped > timeouts)
+	{
+		printf("Draw queue: %d lists dropped in lock step with only %d timeouts\n", dropped, timeouts);
+		check.errors++;
+	}
+
+	if (check.drawn + dropped != DRAW_CHECK_LISTS)
+	{
+		printf("Draw queue: %ld lists drawn and %d dropped, %d were published\n", check.drawn, dropped, DRAW_CHECK_LISTS);
+		check.errors++;
+	}
+
+	printf("Draw queue, %s: %ld lists drawn, %d dropped, %d timeouts, %ld errors\n",
+		lockStep ? "lock step" : "free running", check.drawn, dropped, timeouts, check.errors);
+
+	return check.errors == 0;
+}
+
+#pragma endregion
+
+#pragma region High scores
+
+// Helper function for handing a finished game to the score table, the way the main loop does
+static void finishGame(int score, int wave, bool record)
+{
+	static World world;
+
+	world.gameFinished = true;
+	world.lastGame = (GameResult){ .score = score, .wave = wave };
+	recordFinishedGame(&world, record);
+}
+
+// Helper function that opens the check's table as a new session would
+static void startScoreSession(void)
+{
+	char* argv[] = { "threadchecks", "--scores", SCORES_CHECK_FILE };
+
+	ScoreOptions options;
+	parseScoreOptions(3, argv, &options);
+	initScores(&options);
+}
+
+// Helper function that compares the table with what it should hold, printing every difference
+static int compareScoreTable(const char* stage, const int* scores, const int* waves, int count, Uint32 sessions, Uint32 games)
+{
+	const ScoreTable* table = getScoreTable();
+	int errors = 0;
+
+	if (table->count != count || table->sessions != sessions || table->gamesPlayed != games)
+	{
+		printf("High scores, %s: %d entries, %u sessions and %u games, expected %d, %u and %u\n",
+			stage, table->count, table->sessions, table->gamesPlayed, count, sessions, games);
+		errors++;
+	}
+
+	for (int i = 0; i < min(count, table->count); i++)
+	{
+		if (table->entries[i].score != scores[i] || table->entries[i].wave != waves[i])
+		{
+			printf("High scores, %s: entry %d is %d on wave %d, expected %d on wave %d\n",
+				stage, i, table->entries[i].score, table->entries[i].wave, scores[i], waves[i]);
+			errors++;
+		}
+	}
+
+	return errors;
+}
+
+// Function that plays sessions against a table file: ordering and the cap, a reload, a burst of saves and a damaged file
+static bool checkScores(void)
+{
+	remove(SCORES_CHECK_FILE);
+	remove(SCORES_CHECK_TEMP);
+
+	int errors = 0;
+
+	// Games with the same score keep the order they were played in, games that aren't recorded only leave the table untouched
+	startScoreSession();
+
+	static const int played[] = { 50, 300, 120, 300, 10, 900, 5, 7, 8, 9, 11, 12, 400 };
+	for (int i = 0; i < (int)(sizeof played / sizeof played[0]); i++)
+		finishGame(played[i], i + 1, true);
+	finishGame(99999, 1, false);
+
+	static const int bestScores[MAX_HIGH_SCORES] = { 900, 400, 300, 300, 120, 50, 12, 11, 10, 9 };
+	static const int bestWaves[MAX_HIGH_SCORES] = { 6, 13, 2, 4, 3, 1, 12, 11, 5, 10 };
+	errors += compareScoreTable("first session", bestScores, bestWaves, MAX_HIGH_SCORES, 1, 13);
+
+	if (getScoreTable()->totalScore != 2132 || getScoreTable()->bestWave != 13)
+	{
+		printf("High scores, first session: total %llu and best wave %d, expected 2132 and 13\n",
+			(unsigned long long)getScoreTable()->totalScore, getScoreTable()->bestWave);
+		errors++;
+	}
+
+	quitScores();
+
+	// The table comes back from the file as it was left, and a burst of saves ends with the last one on the disk
+	startScoreSession();
+	errors += compareScoreTable("reloaded", bestScores, bestWaves, MAX_HIGH_SCORES, 2, 13);
+
+	for (int i = 0; i < SCORES_CHECK_BURST; i++)
+		finishGame(1000 + i, 20, true);
+
+	quitScores();
+
+	startScoreSession();
+
+	int burstScores[MAX_HIGH_SCORES], burstWaves[MAX_HIGH_SCORES];
+	for (int i = 0; i < MAX_HIGH_SCORES; i++)
+	{
+		burstScores[i] = 1000 + SCORES_CHECK_BURST - 1 - i;
+		burstWaves[i] = 20;
+	}
+	errors += compareScoreTable("after a burst", burstScores, burstWaves, MAX_HIGH_SCORES, 3, 13 + SCORES_CHECK_BURST);
+
+	quitScores();
+
+	// A damaged file is never loaded, the session starts a new table and saves it over the damaged one
+	size_t size = 0;
+	Uint8* data = (Uint8*)SDL_LoadFile(SCORES_CHECK_FILE, &size);
+	FILE* file = data ? fopen(SCORES_CHECK_FILE, "wb") : NULL;
+
+	if (file)
+	{
+		data[size / 2] ^= 0xFF;
+		fwrite(data, 1, size, file);
+		fclose(file);
+	}
+	else
+	{
+		printf("High scores: couldn't damage %s\n", SCORES_CHECK_FILE);
+		errors++;
+	}
+
+	SDL_free(data);
+
+	startScoreSession();
+	errors += compareScoreTable("damaged file", NULL, NULL, 0, 1, 0);
+	quitScores();
+
+	startScoreSession();
+	errors += compareScoreTable("replaced file", NULL, NULL, 0, 2, 0);
+	quitScores();
+
+	remove(SCORES_CHECK_FILE);
+
+	printf("High scores: %d errors\n", errors);
+
+	return errors == 0;
+}
+
+#pragma endregion
+
+#pragma region Profiler
+
+// Function that plays the render thread timing its phases
+static int profilerCheckThread(void* data)
+{
+	for (int i = 0; i < PROFILER_CHECK_SAMPLES; i++)
+	{
+		beginPhase(PHASE_PRESENT);
+		endPhase(PHASE_PRESENT);
+	}
+
+	return 0;
+}
+
+// Function that reads the stats of a phase while another thread times it, the way the overlay and the profile at exit do
+static bool checkProfiler(void)
+{
+	setProfiling(true);
+
+	SDL_Thread* thread = SDL_CreateThread(profilerCheckThread, "profilerCheck", NULL);
+	if (!thread)
+	{
+		printf("Couldn't start the timing side of the profiler check: %s\n", SDL_GetError());
+		return false;
+	}
+
+	int errors = 0, reads = 0;
+	Uint64 lastCalls = 0;
+	PhaseStats stats;
+
+	do
+	{
+		getPhaseStats(PHASE_PRESENT, &stats);
+		reads++;
+
+		// A torn copy has a sample count that went back or a window that disagrees with the totals. One slow sample can pull the
+		// average over the p99, so both are only held against the bounds
+		bool outOfBounds = stats.min > stats.avg || stats.avg > stats.max || stats.min > stats.p99 || stats.p99 > stats.max;
+		if (stats.calls < lastCalls || (stats.calls > 0 && outOfBounds))
+		{
+			printf("Profiler: %llu calls after %llu, min %.3f avg %.3f p99 %.3f max %.3f\n", (unsigned long long)stats.calls,
+				(unsigned long long)lastCalls, stats.min, stats.avg, stats.p99, stats.max);
+			errors++;
+		}
+
+		lastCalls = stats.calls;
+	} while (stats.calls < PROFILER_CHECK_SAMPLES && errors < 10);
+
+	SDL_WaitThread(thread, NULL);
+	setProfiling(false);
+
+	getPhaseStats(PHASE_PRESENT, &stats);
+	if (stats.calls != PROFILER_CHECK_SAMPLES)
+	{
+		printf("Profiler: %llu calls counted, %d were timed\n", (unsigned long long)stats.calls, PROFILER_CHECK_SAMPLES);
+		errors++;
+	}
+
+	printf("Profiler: %d reads, %d errors\n", reads, errors);
+
+	return errors == 0;
+}
+
+#pragma endregion
+
+int main(int argc, char* argv[])
+{
+	if (SDL_Init(0) != 0)
+	{
+		printf("Couldn't initialize SDL: %s\n", SDL_GetError());
+		return 1;
+	}
+
+	bool success = true;
+
+	// The game waits for every list to be taken, a simulation that doesn't has lists dropped instead
+	success &= checkDrawQueue(true);
+	success &= checkDrawQueue(false);
+
+	// Saves are handed to a writer thread while the game goes on
+	success &= checkScores();
+
+	// The overlay reads the stats of phases the main thread times, the profile at exit the ones the render thread times
+	success &= checkProfiler();
+
+	printf(success ? "All checks passed\n" : "Some checks failed\n");
+
+	SDL_Quit();
+	return success ? 0 : 1;
+}